@@ -116,6 +116,7 @@ static void	draw_cursor(int x, int y);
 static void	move_cur(int dir, unsigned char c, float div);
 static void	move_text(int dir, unsigned char c, float div);
 static void	reload_compoundfont(F_compound *compounds);
+static void	collect_text_fonts(F_compound *c, int **fonts, int **sizes, int *n, int *max);
 static int	prefix_length(char *string, int where_p);
 static void	initialize_char_handler(Window w, void (*cr) (/* ??? */), int bx, int by);
 static void	terminate_char_handler(void);
@@ -386,7 +387,7 @@ overlay_text_input(int x, int y)
 			   work_fontsize);
 	/* get the ZOOMED font for actually drawing on the canvas */
 	canvas_zoomed_font = lookfont(x_fontnum(work_psflag, work_font),
-				  round(work_fontsize*display_zoomscale));
+				  zoomed_font_size(work_fontsize));
 	/* save the working font structure */
 	work_fontstruct = canvas_zoomed_font;
     }
@@ -441,7 +442,8 @@ create_textobject(void)
 	    if ((new_t->cstring = new_string(leng_prefix)) != NULL)
 		strcpy(new_t->cstring, prefix);
 	}
-	size = textsize(canvas_font, leng_prefix, prefix);
+	text_changed(new_t);
+	size = text_size(new_t, canvas_font);
 	new_t->ascent  = size.ascent;
 	new_t->descent = size.descent;
 	new_t->length  = size.length;
@@ -526,7 +528,7 @@ init_text_input(int x, int y)
 			   work_fontsize);
 	    /* get the ZOOMED font for actually drawing on the canvas */
 	    canvas_zoomed_font = lookfont(x_fontnum(work_psflag, work_font),
-			   round(work_fontsize*display_zoomscale));
+			   zoomed_font_size(work_fontsize));
 	    /* save the working font structure */
 	    work_fontstruct = canvas_zoomed_font;
 	} /* (is_newline) */
@@ -704,13 +706,13 @@ new_text(void)
     text->color = cur_pencolor;
     text->depth = work_depth;
     text->pen_style = -1;
-    size = textsize(canvas_font, leng_prefix, prefix);
+    strcpy(text->cstring, prefix);
+    size = text_size(text, canvas_font);
     text->length = size.length;
     text->ascent = size.ascent;
     text->descent = size.descent;
     text->base_x = base_x;
     text->base_y = base_y;
-    strcpy(text->cstring, prefix);
     text->next = NULL;
     return (text);
 }
@@ -1817,15 +1819,67 @@ move_blinking_cursor(int x, int y)
 void
 reload_text_fstructs(void)
 {
+    load_text_fonts(&objects);
+}
+
+/*
+ * Load the zoomed fonts of all texts in compound c (and its compounds),
+ * asking the server for the missing ones together before the texts get them.
+ */
+
+void
+load_text_fonts(F_compound *c)
+{
+    int		   *fonts = NULL, *sizes = NULL;
+    int		    n = 0, max = 0;
     F_text	   *t;
 
+    collect_text_fonts(c, &fonts, &sizes, &n, &max);
+    load_xfonts(n, fonts, sizes);
+    free(fonts);
+    free(sizes);
+
     /* reload the compound objects' texts */
-    reload_compoundfont(objects.compounds);
+    reload_compoundfont(c->compounds);
     /* and the separate texts */
-    for (t=objects.texts; t != NULL; t = t->next)
+    for (t=c->texts; t != NULL; t = t->next)
 	reload_text_fstruct(t);
 }
 
+/*
+ * Add the font number and zoomed size of each text in compound c to
+ * fonts[] and sizes[].
+ */
+
+static void
+collect_text_fonts(F_compound *c, int **fonts, int **sizes, int *n, int *max)
+{
+    F_compound	   *cc;
+    F_text	   *t;
+    int		   *f, *s;
+
+    for (t=c->texts; t != NULL; t = t->next) {
+	if (*n >= *max) {
+	    *max = *max? 2 * *max: 64;
+	    f = (int *) realloc(*fonts, *max * sizeof(int));
+	    if (f)
+		*fonts = f;
+	    s = (int *) realloc(*sizes, *max * sizeof(int));
+	    if (s)
+		*sizes = s;
+	    if (f == NULL || s == NULL) {
+		*max = *n;
+		return;
+	    }
+	}
+	(*fonts)[*n] = x_fontnum(psfont_text(t), t->font);
+	(*sizes)[*n] = zoomed_font_size(t->size);
+	(*n)++;
+    }
+    for (cc = c->compounds; cc != NULL; cc = cc->next)
+	collect_text_fonts(cc, fonts, sizes, n, max);
+}
+
 /*
  * Reload the font structure for texts in compounds.
  */
@@ -1847,8 +1901,9 @@ void
 reload_text_fstruct(F_text *t)
 {
     t->fontstruct = lookfont(x_fontnum(psfont_text(t), t->font),
-			round(t->size*display_zoomscale));
+			zoomed_font_size(t->size));
     t->zoom = zoomscale;
+    text_changed(t);
 }
 
 
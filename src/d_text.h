@@ -21,6 +21,7 @@ extern void	erase_char_string(void);
 extern void	finish_text_input(int x, int y, int shift);
 extern void	reload_text_fstruct(F_text *t);
 extern void	reload_text_fstructs(void);
+extern void	load_text_fonts(F_compound *c);
 extern Boolean	text_selection_active;
 extern Boolean	ConvertSelection();
 extern void	LoseSelection(), TransferSelectionDone();
@@ -93,6 +93,7 @@ open_this_compound(F_compound *c, Boolean vis)
   #endif
   *d = objects;			/* Preserve the parent, it points to c */
   objects = *c;
+  clear_last_objects(&objects);
   objects.GABPtr = c;		/* Where original compound came from */
   objects.draw_parent = vis;
   if (!close_popup_isup)
@@ -145,6 +146,7 @@ close_compound(void)
 			&objects.secorner.x, &objects.secorner.y);
     *d = objects;		/* Put in any changes */
     objects = *c;		/* Restore compound above */
+    clear_last_objects(&objects);
     /* user may have deleted all objects inside the compound */
     if (object_count(d)==0) {
 	list_delete_compound(&objects.compounds, d);
@@ -187,6 +189,7 @@ close_all_compounds(void)
 			&objects.secorner.x, &objects.secorner.y);
       *d = objects;		/* Put in any changes */
       objects = *c;
+      clear_last_objects(&objects);
       /* user may have deleted all objects inside the compound */
       if (object_count(d)==0) {
 	list_delete_compound(&objects.compounds, d);
@@ -307,4 +307,6 @@ void delete_all(void)
     object_tails.lines = NULL;
     object_tails.splines = NULL;
     object_tails.texts = NULL;
+    /* the figure lists have been emptied, forget what was indexed for them */
+    clear_last_objects(&objects);
 }
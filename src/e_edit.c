@@ -1500,10 +1500,11 @@ get_new_compound_values(void)
 	if (t->cstring)
 	    free(t->cstring);
 	t->cstring = strdup(panel_get_value(compound_text_panels[i]));
+	text_changed(t);
 	/* calculate new size */
 	/* get the fontstruct for zoom = 1 to get the size of the string */
 	canvas_font = lookfont(x_fontnum(psfont_text(t), t->font), t->size);
-	size = textsize(canvas_font, strlen(t->cstring), t->cstring);
+	size = text_size(t, canvas_font);
 	t->length = size.length;
 	t->ascent = size.ascent;
 	t->descent = size.descent;
@@ -1808,9 +1809,12 @@ void make_window_line(F_line *l)
 #ifdef USE_JPEG
 	     new_l->pic->pic_cache->subtype == T_PIC_JPEG ||
 #endif /* USE_JPEG */
-	     new_l->pic->pic_cache->subtype == T_PIC_GIF))
-		sprintf(buf,"%3d",new_l->pic->pic_cache->numcols);
-	else
+	     new_l->pic->pic_cache->subtype == T_PIC_GIF)) {
+		if (new_l->pic->pic_cache->rgb)
+		    strcpy(buf,"RGB");
+		else
+		    sprintf(buf,"%3d",new_l->pic->pic_cache->numcols);
+	} else
 		strcpy(buf,"N/A");
 
 	FirstArg(XtNfromVert, below);
@@ -2156,9 +2160,12 @@ get_new_line_values(void)
 #ifdef USE_JPEG
 	     new_l->pic->pic_cache->subtype == T_PIC_JPEG ||
 #endif /* USE_JPEG */
-	     new_l->pic->pic_cache->subtype == T_PIC_GIF)
-		sprintf(buf,"%3d",new_l->pic->pic_cache->numcols);
-	else
+	     new_l->pic->pic_cache->subtype == T_PIC_GIF) {
+		if (new_l->pic->pic_cache->rgb)
+		    strcpy(buf,"RGB");
+		else
+		    sprintf(buf,"%3d",new_l->pic->pic_cache->numcols);
+	} else
 		strcpy(buf,"N/A");
 	SetValues(pic_colors);
 
@@ -2183,7 +2190,10 @@ get_new_line_values(void)
 		new_l->pic->pic_cache->bit_size.x, new_l->pic->pic_cache->bit_size.y);
 	/* recolor and redraw all pictures if this is a NEW picture */
 	if (reread_file || !existing && file_changed && !appres.monochrome &&
-	   (new_l->pic->pic_cache->numcols > 0) && (new_l->pic->pic_cache->bitmap != 0)) {
+	   (new_l->pic->pic_cache->numcols > 0 || new_l->pic->pic_cache->rgb) &&
+	   PIC_PRESENT(new_l->pic->pic_cache)) {
+		char	*pic_type;
+
 		reread_file = False;
 		/* remap all picture colors */
 		remap_imagecolors();
@@ -2191,8 +2201,7 @@ get_new_line_values(void)
 		set_cmap(XtWindow(popup));
 		/* and redraw all of the pictures already on the canvas */
 		redraw_images(&objects);
-		put_msg("Read %s image of %dx%d pixels and %d colors OK",
-			  new_l->pic->pic_cache->subtype == T_PIC_EPS? "EPS":
+		pic_type = new_l->pic->pic_cache->subtype == T_PIC_EPS? "EPS":
 			    new_l->pic->pic_cache->subtype == T_PIC_GIF? "GIF":
 #ifdef USE_JPEG
 			      new_l->pic->pic_cache->subtype == T_PIC_JPEG? "JPEG":
@@ -2204,7 +2213,13 @@ get_new_line_values(void)
 #ifdef USE_XPM
 				        new_l->pic->pic_cache->subtype == T_PIC_XPM? "XPM":
 #endif /* USE_XPM */
-					"Unknown",
+					"Unknown";
+		/* true-color pictures have no colormap of their own */
+		if (new_l->pic->pic_cache->numcols == 0)
+		    put_msg("Read %s true-color image of %dx%d pixels OK", pic_type,
+			new_l->pic->pic_cache->bit_size.x, new_l->pic->pic_cache->bit_size.y);
+		else
+		    put_msg("Read %s image of %dx%d pixels and %d colors OK", pic_type,
 			new_l->pic->pic_cache->bit_size.x, new_l->pic->pic_cache->bit_size.y,
 			new_l->pic->pic_cache->numcols);
 		app_flush();
@@ -2491,6 +2506,7 @@ get_new_text_values(void)
 	free(new_t->cstring);
     /* get the text string itself */
     new_t->cstring = strdup(panel_get_value(text_panel));
+    text_changed(new_t);
     /* get any comments */
     new_t->comments = strdup(panel_get_value(comments_panel));
     #ifdef SLIDES_SUPPORT
@@ -2500,7 +2516,7 @@ get_new_text_values(void)
     #endif
     /* get the fontstruct for zoom = 1 to get the size of the string */
     canvas_font = lookfont(x_fontnum(psfont_text(new_t), new_t->font), new_t->size);
-    size = textsize(canvas_font, strlen(new_t->cstring), new_t->cstring);
+    size = text_size(new_t, canvas_font);
     new_t->ascent = size.ascent;
     new_t->descent = size.descent;
     new_t->length = size.length;
@@ -5549,7 +5565,9 @@ image_edit_button(Widget panel_local, XtPointer closure, XtPointer call_data)
            causes a reread of the file as it thinks the name has changed  */
         stat(s, &new_stat );
         if ( original_stat.st_mtime != new_stat.st_mtime ) {
+	    free_pic_levels(new_l->pic->pic_cache);
 	    new_l->pic->pic_cache->bitmap = NULL;
+	    new_l->pic->pic_cache->evicted = False;
 	    push_apply_button();
 	}
 
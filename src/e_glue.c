@@ -231,6 +231,8 @@ int compose_compound(F_compound *c)
     get_text(&c->texts);
     get_arc(&c->arcs);
     get_compound(&c->compounds);
+    /* the last objects of the figure may have gone into the compound */
+    clear_last_objects(&objects);
     /* now update the layer buttons */
     defer_update_layers = False;
     update_layers();
@@ -313,6 +315,10 @@ sel_arc(int xmin, int ymin, int xmax, int ymax)
 	if (!active_object_slides(a, O_ARC))
 	    continue;
 	#endif
+	/* the first point is inside the bound, so rule out most arcs cheaply */
+	if (a->point[0].x < xmin || a->point[0].x > xmax ||
+	    a->point[0].y < ymin || a->point[0].y > ymax)
+		continue;
 	arc_bound(a, &llx, &lly, &urx, &ury);
 	if (xmin > llx)
 	    continue;
@@ -424,6 +430,10 @@ sel_spline(int xmin, int ymin, int xmax, int ymax)
 	if (!active_object_slides(s,O_SPLINE))
 	    continue;
 	#endif
+	/* so are the control points of a spline */
+	if (s->points->x < xmin || s->points->x > xmax ||
+	    s->points->y < ymin || s->points->y > ymax)
+		continue;
 	spline_bound(s, &llx, &lly, &urx, &ury);
 	if (xmin > llx)
 	    continue;
@@ -518,12 +528,7 @@ sel_compound(int xmin, int ymin, int xmax, int ymax)
     F_compound	   *c;
 
     for (c = objects.compounds; c != NULL; c = c->next) {
-	if (!any_active_in_compound(c))
-	    continue;
-	#ifdef SLIDES_SUPPORT
-	if (!active_object_slides (c, O_COMPOUND))
-	    continue;
-	#endif
+	/* test the stored corners before walking the compound for its layers */
 	if (xmin > c->nwcorner.x)
 	    continue;
 	if (xmax < c->secorner.x)
@@ -532,6 +537,12 @@ sel_compound(int xmin, int ymin, int xmax, int ymax)
 	    continue;
 	if (ymax < c->secorner.y)
 	    continue;
+	if (!any_active_in_compound(c))
+	    continue;
+	#ifdef SLIDES_SUPPORT
+	if (!active_object_slides (c, O_COMPOUND))
+	    continue;
+	#endif
 	c->tagged = 1 - c->tagged;
 	toggle_compoundhighlight(c);
     }
@@ -48,6 +48,9 @@ float		act_rotnangle;
 
 static int	copy;
 
+/* cosine and sine of the rotation, only worked out when the angle changes */
+static double	rot_angle = 0.0, rot_cos = 1.0, rot_sin = 0.0;
+
 static void	init_rotate(F_line *p, int type, int x, int y, int px, int py);
 static void	set_unset_center(int x, int y);
 static void	init_copynrotate(F_line *p, int type, int x, int y, int px, int py);
@@ -55,6 +58,7 @@ static void	rotate_selected(void);
 static void	rotate_search(F_line *p, int type, int x, int y, int px, int py);
 static void	init_rotateline(F_line *l, int px, int py);
 static void	init_rotatetext(F_text *t, int px, int py);
+static void	set_rotation(void);
 
 
 void init_rotatearc (F_arc *a, int px, int py);
@@ -519,48 +523,35 @@ void rotate_compound(F_compound *c, int x, int y)
 
 void rotate_point(F_point *p, int x, int y)
 {
-    /* rotate point p about coordinate (x, y) */
-    double	    dx, dy;
-    double	    cosa, sina, mag, theta;
-
-    dx = p->x - x;
-    dy = y - p->y;
-    if (dx == 0 && dy == 0)
-	return;
-
-    theta = compute_angle(dx, dy);
-    theta -= (double) (rotn_dirn * act_rotnangle * M_PI / 180.0);
-    if (theta < 0.0)
-	theta += M_2PI;
-    else if (theta >= M_2PI - 0.001)
-	theta -= M_2PI;
-    mag = sqrt(dx * dx + dy * dy);
-    cosa = mag * cos(theta);
-    sina = mag * sin(theta);
-    p->x = round(x + cosa);
-    p->y = round(y - sina);
+    rotate_xy(&p->x, &p->y, x, y);
 }
 
 void rotate_xy(int *orig_x, int *orig_y, int x, int y)
 {
     /* rotate coord (orig_x, orig_y) about coordinate (x, y) */
     double	    dx, dy;
-    double	    cosa, sina, mag, theta;
 
     dx = *orig_x - x;
     dy = y - *orig_y;
     if (dx == 0 && dy == 0)
 	return;
 
-    theta = compute_angle(dx, dy);
-    theta -= (double) (rotn_dirn * act_rotnangle * M_PI / 180.0);
-    if (theta < 0.0)
-	theta += M_2PI;
-    else if (theta >= M_2PI - 0.001)
-	theta -= M_2PI;
-    mag = sqrt(dx * dx + dy * dy);
-    cosa = mag * cos(theta);
-    sina = mag * sin(theta);
-    *orig_x = round(x + cosa);
-    *orig_y = round(y - sina);
+    /* same as turning the angle of (dx, dy) back by the rotation, but
+       without working out that angle (and its cos and sin) for every point */
+    set_rotation();
+    *orig_x = round(x + dx * rot_cos + dy * rot_sin);
+    *orig_y = round(y - (dy * rot_cos - dx * rot_sin));
+}
+
+static void
+set_rotation(void)
+{
+    double	    angle;
+
+    angle = (double) (rotn_dirn * act_rotnangle * M_PI / 180.0);
+    if (angle != rot_angle) {
+	rot_angle = angle;
+	rot_cos = cos(angle);
+	rot_sin = sin(angle);
+    }
 }
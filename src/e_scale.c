@@ -907,11 +907,12 @@ rescale_dimension_line(F_compound *dimline, float scalex, float scaley, int refx
 	 if (text->cstring)
 	    free(text->cstring);
 	 text->cstring = strdup(str);
+	 text_changed(text);
     }
     /* recalculate text sizes */
     text->fontstruct = lookfont(x_fontnum(text->flags, text->font), text->size);
     text->zoom = 1.0;
-    tsize = textsize(text->fontstruct, strlen(text->cstring), text->cstring);
+    tsize = text_size(text, text->fontstruct);
     text->ascent  = tsize.ascent;
     text->descent = tsize.descent;
     text->length  = tsize.length;
@@ -543,8 +543,8 @@ void update_text(F_text *text)
         up_part(text->slides, copy_slides (cur_slides), I_SLIDES);
     }
     #endif
-    size = textsize(lookfont(x_fontnum(psfont_text(text), text->font),
-			text->size), strlen(text->cstring), text->cstring);
+    size = text_size(text, lookfont(x_fontnum(psfont_text(text), text->font),
+			text->size));
     text->ascent = size.ascent;
     text->descent = size.descent;
     text->length = size.length;
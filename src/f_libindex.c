@@ -0,0 +1,295 @@
+/*
+ * FIG : Facility for Interactive Generation of figures
+ * Copyright (c) 1985-1988 by Supoj Sutanthavibul
+ * Parts Copyright (c) 1989-2007 by Brian V. Smith
+ *
+ * Any party obtaining a copy of these files is granted, free of charge, a
+ * full and unrestricted irrevocable, world-wide, paid up, royalty-free,
+ * nonexclusive right and license to deal in this software and documentation
+ * files (the "Software"), including without limitation the rights to use,
+ * copy, modify, merge, publish distribute, sublicense and/or sell copies of
+ * the Software, and to permit persons who receive copies from any such
+ * party to do so, with the only requirement being that the above copyright
+ * and this permission notice remain intact.
+ *
+ */
+
+/*
+ * Library index files.
+ *
+ * For each library directory (and each "key", which the caller uses for
+ * the icon size and visual) there is one file in the library cache
+ * directory (resource library_cache_dir).  It holds, for every object,
+ * its name, the modification time and size of its .fig file, its comments
+ * and its icon pixels:
+ *
+ *	#FIG library index 1
+ *	name
+ *	mtime size comment-length icon-length
+ *	comment bytes, icon bytes, newline
+ *	...
+ *
+ * An entry is only used while the time and size still match the file.
+ */
+
+#include "fig.h"
+#include "resources.h"
+#include "f_libindex.h"
+
+#define LIB_INDEX_MAGIC	"#FIG library index 1\n"
+
+static char	*lib_index_name(char *library_dir, char *key);
+static int	 entry_cmp(const void *a, const void *b);
+
+/* make an empty index for library_dir; returns NULL if there is no cache directory */
+
+struct lib_index *
+new_lib_index(char *library_dir, char *key)
+{
+    struct lib_index *index;
+    char	   *file;
+
+    if ((file = lib_index_name(library_dir, key)) == NULL)
+	return NULL;
+    if ((index = (struct lib_index *) malloc(sizeof(struct lib_index))) == NULL) {
+	free(file);
+	return NULL;
+    }
+    index->file = file;
+    index->nentries = 0;
+    index->maxentries = 0;
+    index->entries = NULL;
+    index->sorted = True;
+    return index;
+}
+
+/* read the index of library_dir; returns NULL if there isn't a (good) one */
+
+struct lib_index *
+read_lib_index(char *library_dir, char *key)
+{
+    struct lib_index *index;
+    struct lib_index_entry *e;
+    FILE	   *fp;
+    char	    line[PATH_MAX+2], *c;
+    long	    mtime, size, clen, tlen;
+    Boolean	    ok;
+
+    if ((index = new_lib_index(library_dir, key)) == NULL)
+	return NULL;
+    if ((fp = fopen(index->file, "rb")) == NULL) {
+	free_lib_index(index);
+	return NULL;
+    }
+    ok = fgets(line, sizeof(line), fp) != NULL && strcmp(line, LIB_INDEX_MAGIC) == 0;
+    while (ok && fgets(line, sizeof(line), fp) != NULL) {
+	ok = False;
+	if ((c = strchr(line, '\n')) == NULL)
+	    break;
+	*c = '\0';
+	if (index->nentries >= index->maxentries) {
+	    index->maxentries = index->maxentries ? 2 * index->maxentries : 64;
+	    e = (struct lib_index_entry *) realloc(index->entries,
+				index->maxentries * sizeof(struct lib_index_entry));
+	    if (e == NULL)
+		break;
+	    index->entries = e;
+	}
+	e = &index->entries[index->nentries];
+	e->name = e->comments = NULL;
+	e->thumb = NULL;
+	if (fscanf(fp, "%ld %ld %ld %ld", &mtime, &size, &clen, &tlen) != 4 ||
+	    getc(fp) != '\n' || clen < 0 || tlen < 0)
+		break;
+	e->name = strdup(line);
+	e->mtime = (time_t) mtime;
+	e->size = (off_t) size;
+	e->thumblen = tlen;
+	e->comments = malloc(clen + 1);
+	e->thumb = (unsigned char *) malloc(tlen > 0 ? tlen : 1);
+	index->nentries++;
+	if (e->name == NULL || e->comments == NULL || e->thumb == NULL ||
+	    fread(e->comments, 1, clen, fp) != clen ||
+	    fread(e->thumb, 1, tlen, fp) != tlen || getc(fp) != '\n')
+		break;
+	e->comments[clen] = '\0';
+	index->sorted = False;
+	ok = True;
+    }
+    fclose(fp);
+    if (!ok) {
+	if (appres.DEBUG)
+	    fprintf(stderr,"Ignoring bad library index %s\n", index->file);
+	free_lib_index(index);
+	return NULL;
+    }
+    return index;
+}
+
+/* write the index to its file, via a temporary file so readers never see half of it */
+
+Boolean
+write_lib_index(struct lib_index *index)
+{
+    struct lib_index_entry *e;
+    FILE	   *fp;
+    char	    tmpname[PATH_MAX+8], *c;
+    int		    i;
+    Boolean	    ok;
+
+    strcpy(tmpname, index->file);
+    if ((c = strrchr(tmpname, '/')) != NULL) {
+	*c = '\0';
+	if (!make_cache_dir(tmpname))
+	    return False;
+    }
+    sprintf(tmpname, "%s.%d", index->file, (int) getpid());
+    if ((fp = fopen(tmpname, "wb")) == NULL)
+	return False;
+    ok = fputs(LIB_INDEX_MAGIC, fp) >= 0;
+    for (i = 0; ok && i < index->nentries; i++) {
+	e = &index->entries[i];
+	ok = fprintf(fp, "%s\n%ld %ld %ld %ld\n", e->name, (long) e->mtime,
+			(long) e->size, (long) strlen(e->comments), e->thumblen) > 0 &&
+		fwrite(e->comments, 1, strlen(e->comments), fp) == strlen(e->comments) &&
+		fwrite(e->thumb, 1, e->thumblen, fp) == e->thumblen &&
+		putc('\n', fp) != EOF;
+    }
+    if (fclose(fp) != 0)
+	ok = False;
+    if (!ok || rename(tmpname, index->file) != 0) {
+	unlink(tmpname);
+	return False;
+    }
+    return True;
+}
+
+void
+free_lib_index(struct lib_index *index)
+{
+    int		    i;
+
+    for (i = 0; i < index->nentries; i++) {
+	free(index->entries[i].name);
+	free(index->entries[i].comments);
+	free(index->entries[i].thumb);
+    }
+    free(index->entries);
+    free(index->file);
+    free(index);
+}
+
+static int
+entry_cmp(const void *a, const void *b)
+{
+    return strcmp(((struct lib_index_entry *) a)->name,
+		  ((struct lib_index_entry *) b)->name);
+}
+
+/* return the entry for object "name" if it is still current for its file status st */
+
+struct lib_index_entry *
+find_lib_index_entry(struct lib_index *index, char *name, struct stat *st)
+{
+    struct lib_index_entry key, *e;
+
+    /* sort the entries on the first lookup, then search by halves */
+    if (!index->sorted) {
+	qsort(index->entries, index->nentries, sizeof(struct lib_index_entry),
+		entry_cmp);
+	index->sorted = True;
+    }
+    key.name = name;
+    e = (struct lib_index_entry *) bsearch(&key, index->entries, index->nentries,
+		sizeof(struct lib_index_entry), entry_cmp);
+    if (e == NULL || e->mtime != st->st_mtime || e->size != st->st_size)
+	return NULL;
+    return e;
+}
+
+/* add an entry to the index, copying comments and thumb */
+
+Boolean
+add_lib_index_entry(struct lib_index *index, char *name, struct stat *st,
+			char *comments, unsigned char *thumb, long thumblen)
+{
+    struct lib_index_entry *e;
+
+    if (strchr(name, '\n') != NULL)
+	return False;
+    if (index->nentries >= index->maxentries) {
+	index->maxentries = index->maxentries ? 2 * index->maxentries : 64;
+	e = (struct lib_index_entry *) realloc(index->entries,
+				index->maxentries * sizeof(struct lib_index_entry));
+	if (e == NULL)
+	    return False;
+	index->entries = e;
+    }
+    e = &index->entries[index->nentries];
+    if (comments == NULL)
+	comments = "";
+    e->name = strdup(name);
+    e->comments = strdup(comments);
+    e->thumb = (unsigned char *) malloc(thumblen > 0 ? thumblen : 1);
+    if (e->name == NULL || e->comments == NULL || e->thumb == NULL) {
+	free(e->name);
+	free(e->comments);
+	free(e->thumb);
+	return False;
+    }
+    memcpy(e->thumb, thumb, thumblen);
+    e->thumblen = thumblen;
+    e->mtime = st->st_mtime;
+    e->size = st->st_size;
+    index->nentries++;
+    index->sorted = False;
+    return True;
+}
+
+/*
+ * Name of the index file of library_dir: the directory path with '%'
+ * changed to "%25" and '/' to "%2F", so no two paths give the same name,
+ * followed by the key.
+ */
+
+static char *
+lib_index_name(char *library_dir, char *key)
+{
+    char	    name[PATH_MAX], *c;
+    int		    len;
+
+    if (appres.library_cache_dir == NULL || appres.library_cache_dir[0] == '\0')
+	return NULL;
+    len = sprintf(name, "%.*s/", PATH_MAX/2, appres.library_cache_dir);
+    for (c = library_dir; *c && len < PATH_MAX - (int) strlen(key) - 10; c++) {
+	if (*c == '/' || *c == '%')
+	    len += sprintf(&name[len], "%%%02X", (unsigned char) *c);
+	else
+	    name[len++] = *c;
+    }
+    if (*c != '\0')
+	return NULL;		/* path too long */
+    sprintf(&name[len], "-%s.idx", key);
+    return strdup(name);
+}
+
+/* make directory dir and any missing parents */
+
+Boolean
+make_cache_dir(char *dir)
+{
+    struct stat	    st;
+    char	   *c;
+
+    if (stat(dir, &st) == 0)
+	return S_ISDIR(st.st_mode);
+    if ((c = strrchr(dir, '/')) != NULL && c != dir) {
+	*c = '\0';
+	if (!make_cache_dir(dir)) {
+	    *c = '/';
+	    return False;
+	}
+	*c = '/';
+    }
+    return mkdir(dir, 0755) == 0 || errno == EEXIST;
+}
@@ -0,0 +1,54 @@
+/*
+ * FIG : Facility for Interactive Generation of figures
+ * Copyright (c) 1985-1988 by Supoj Sutanthavibul
+ * Parts Copyright (c) 1989-2007 by Brian V. Smith
+ *
+ * Any party obtaining a copy of these files is granted, free of charge, a
+ * full and unrestricted irrevocable, world-wide, paid up, royalty-free,
+ * nonexclusive right and license to deal in this software and documentation
+ * files (the "Software"), including without limitation the rights to use,
+ * copy, modify, merge, publish distribute, sublicense and/or sell copies of
+ * the Software, and to permit persons who receive copies from any such
+ * party to do so, with the only requirement being that the above copyright
+ * and this permission notice remain intact.
+ *
+ */
+
+#ifndef F_LIBINDEX_H
+#define F_LIBINDEX_H
+
+/*
+ * Index of the objects in a library directory, kept in the user's
+ * library cache directory so the icons need not be drawn from the
+ * .fig files each time the library is opened.
+ */
+
+struct lib_index_entry {
+    char	   *name;		/* object name (file name without .fig) */
+    time_t	    mtime;		/* modification time of the .fig file */
+    off_t	    size;		/* and its size */
+    char	   *comments;		/* comments of the object */
+    unsigned char  *thumb;		/* icon pixels (format is up to the caller) */
+    long	    thumblen;		/* number of bytes in thumb */
+};
+
+struct lib_index {
+    char	   *file;		/* name of the index file */
+    int		    nentries;
+    int		    maxentries;
+    struct lib_index_entry *entries;
+    Boolean	    sorted;		/* entries are in order of name */
+};
+
+extern struct lib_index *new_lib_index(char *library_dir, char *key);
+extern struct lib_index *read_lib_index(char *library_dir, char *key);
+extern Boolean	write_lib_index(struct lib_index *index);
+extern void	free_lib_index(struct lib_index *index);
+extern struct lib_index_entry *find_lib_index_entry(struct lib_index *index,
+			char *name, struct stat *st);
+extern Boolean	add_lib_index_entry(struct lib_index *index, char *name,
+			struct stat *st, char *comments,
+			unsigned char *thumb, long thumblen);
+extern Boolean	make_cache_dir(char *dir);
+
+#endif /* F_LIBINDEX_H */
@@ -0,0 +1,553 @@
+/*
+ * FIG : Facility for Interactive Generation of figures
+ * Copyright (c) 1985-1988 by Supoj Sutanthavibul
+ * Parts Copyright (c) 1989-2007 by Brian V. Smith
+ *
+ * Any party obtaining a copy of these files is granted, free of charge, a
+ * full and unrestricted irrevocable, world-wide, paid up, royalty-free,
+ * nonexclusive right and license to deal in this software and documentation
+ * files (the "Software"), including without limitation the rights to use,
+ * copy, modify, merge, publish distribute, sublicense and/or sell copies of
+ * the Software, and to permit persons who receive copies from any such
+ * party to do so, with the only requirement being that the above copyright
+ * and this permission notice remain intact.
+ *
+ */
+
+/*
+ * Searching the object libraries.
+ *
+ * The name, library name and comment lines of every library object are
+ * kept in the file "search.idx" in the library cache directory, so only
+ * new or changed .fig files are read when the libraries are scanned
+ * again.  After a scan, all words in that text are put in a table of
+ * (word, objects) sorted by word, and a query finds the objects that have,
+ * for each of its words, a word starting with it.
+ *
+ * A scan is libsearch_begin(), libsearch_add_dir() for each library
+ * directory, and libsearch_end().
+ */
+
+#include "fig.h"
+#include "resources.h"
+#include "dirstruct.h"
+#include "f_libindex.h"
+#include "f_libsearch.h"
+
+#define LIBSEARCH_MAGIC		"#FIG library search 2\n"
+#define LIBSEARCH_FILE		"search.idx"
+#define MAX_LIB_COMMENTS	2000	/* max length of the comments kept for an object */
+#define OBJ_HASH_SIZE		4096
+
+struct ls_term {
+    char	   *word;
+    int		   *ids;		/* objects with the word, in increasing order */
+    int		    nids;
+};
+
+struct ls_pair {
+    char	   *word;
+    int		    id;
+};
+
+static struct libsearch_obj *objs = NULL;
+static int	nobjs = 0, maxobjs = 0;
+static Boolean	objs_read = False;	/* search file has been read */
+static Boolean	objs_changed = False;	/* objects added, changed or removed since */
+
+static int	obj_hash[OBJ_HASH_SIZE];
+static int     *obj_chain = NULL;	/* next object in the same hash chain */
+
+static struct ls_term *terms = NULL;
+static int	nterms = 0;
+static Boolean	terms_valid = False;	/* terms are those of the current objects */
+
+static struct libsearch_obj **hits = NULL;
+
+static void	read_search_file(void);
+static void	write_search_file(void);
+static char    *search_file_name(void);
+static char    *read_fig_comments(char *file);
+static struct libsearch_obj *new_obj(void);
+static unsigned int obj_hashval(char *dir, char *name);
+static void	hash_obj(int i);
+static void	build_terms(void);
+static void	free_terms(void);
+static int	next_word(char **s, char *word, int size);
+static int	pair_comp(const void *p1, const void *p2);
+
+/* start a scan of the libraries */
+
+void
+libsearch_begin(void)
+{
+    int		    i;
+
+    if (!objs_read) {
+	read_search_file();
+	objs_read = True;
+	objs_changed = False;
+    }
+    for (i = 0; i < OBJ_HASH_SIZE; i++)
+	obj_hash[i] = -1;
+    for (i = 0; i < nobjs; i++) {
+	objs[i].seen = False;
+	objs[i].library = NULL;
+	if (objs[i].dir && objs[i].name)
+	    hash_obj(i);
+    }
+}
+
+/*
+ * Add the objects in library directory dir, with long name libname.
+ * "library" is kept with each object for the caller.
+ * Returns the number of .fig files that had to be read.
+ */
+
+int
+libsearch_add_dir(char *dir, char *libname, void *library)
+{
+    DIR		   *dirp;
+    DIRSTRUCT	   *dp;
+    struct stat	    st;
+    struct libsearch_obj *o;
+    char	    path[PATH_MAX], name[PATH_MAX], *c;
+    int		    i, nread;
+
+    if ((dirp = opendir(dir)) == NULL)
+	return 0;
+    nread = 0;
+    for (dp = readdir(dirp); dp != NULL; dp = readdir(dirp)) {
+	/* same choice of files as MakeLibraryFileList() */
+	if (dp->d_name[0] == '.' || (c = strstr(dp->d_name, ".fig")) == NULL ||
+	    strstr(dp->d_name, ".fig.bak") != NULL ||
+	    strlen(dir) + strlen(dp->d_name) + 2 > PATH_MAX)
+		continue;
+	sprintf(path, "%s/%s", dir, dp->d_name);
+	if (stat(path, &st) != 0 || S_ISDIR(st.st_mode))
+	    continue;
+	strcpy(name, dp->d_name);
+	name[c - dp->d_name] = '\0';
+
+	for (i = obj_hash[obj_hashval(dir, name)]; i >= 0; i = obj_chain[i])
+	    if (strcmp(objs[i].name, name) == 0 && strcmp(objs[i].dir, dir) == 0)
+		break;
+	if (i >= 0) {
+	    o = &objs[i];
+	    if (strcmp(o->libname, libname) != 0) {
+		free(o->libname);
+		o->libname = strdup(libname);
+		objs_changed = True;
+	    }
+	} else {
+	    if ((o = new_obj()) == NULL)
+		break;
+	    o->dir = strdup(dir);
+	    o->libname = strdup(libname);
+	    o->name = strdup(name);
+	    o->comments = NULL;
+	    o->mtime = 0;
+	    o->size = -1;
+	    hash_obj(nobjs - 1);
+	}
+	o->seen = True;
+	o->library = library;
+	if (o->comments == NULL || o->mtime != st.st_mtime || o->size != st.st_size) {
+	    free(o->comments);
+	    o->comments = read_fig_comments(path);
+	    o->mtime = st.st_mtime;
+	    o->size = st.st_size;
+	    objs_changed = True;
+	    nread++;
+	}
+    }
+    closedir(dirp);
+    return nread;
+}
+
+/* finish a scan: forget objects that have gone, save and index the rest */
+
+void
+libsearch_end(void)
+{
+    int		    i, j;
+
+    for (i = j = 0; i < nobjs; i++) {
+	if (objs[i].seen && objs[i].dir && objs[i].libname &&
+	    objs[i].name && objs[i].comments) {
+		objs[j++] = objs[i];
+	} else {
+	    free(objs[i].dir);
+	    free(objs[i].libname);
+	    free(objs[i].name);
+	    free(objs[i].comments);
+	    objs_changed = True;
+	}
+    }
+    nobjs = j;
+    /* nothing to do when the libraries haven't changed since the last scan */
+    if (objs_changed) {
+	write_search_file();
+	objs_changed = False;
+	terms_valid = False;
+    }
+    if (!terms_valid) {
+	build_terms();
+	terms_valid = True;
+    }
+}
+
+/*
+ * Find the objects that match all words of query.  A pointer to an
+ * array of them is put in *hitp, valid until the next query or scan.
+ * Returns the number of objects found.
+ */
+
+int
+libsearch_query(char *query, struct libsearch_obj ***hitp)
+{
+    char	    word[80];
+    int		   *count, *stamp;
+    int		    nwords, len, lo, hi, mid, t, k, i, nhits;
+
+    *hitp = NULL;
+    if (nobjs == 0)
+	return 0;
+    count = (int *) calloc(nobjs, sizeof(int));
+    stamp = (int *) calloc(nobjs, sizeof(int));
+    free(hits);
+    hits = (struct libsearch_obj **) malloc(nobjs * sizeof(struct libsearch_obj *));
+    if (count == NULL || stamp == NULL || hits == NULL) {
+	free(count);
+	free(stamp);
+	return 0;
+    }
+
+    nwords = 0;
+    while ((len = next_word(&query, word, sizeof(word))) > 0) {
+	nwords++;
+	/* first term not less than word */
+	lo = 0;
+	hi = nterms;
+	while (lo < hi) {
+	    mid = (lo + hi) / 2;
+	    if (strcmp(terms[mid].word, word) < 0)
+		lo = mid + 1;
+	    else
+		hi = mid;
+	}
+	/* all terms starting with word */
+	for (t = lo; t < nterms && strncmp(terms[t].word, word, len) == 0; t++)
+	    for (k = 0; k < terms[t].nids; k++) {
+		i = terms[t].ids[k];
+		if (stamp[i] != nwords) {
+		    stamp[i] = nwords;
+		    count[i]++;
+		}
+	    }
+    }
+
+    nhits = 0;
+    if (nwords > 0)
+	for (i = 0; i < nobjs; i++)
+	    if (count[i] == nwords)
+		hits[nhits++] = &objs[i];
+    free(count);
+    free(stamp);
+    *hitp = hits;
+    return nhits;
+}
+
+/* make the sorted table of words and the objects they appear in */
+
+static void
+build_terms(void)
+{
+    struct ls_pair *pairs, *p;
+    char	    word[80], *s;
+    int		    npairs, maxpairs, i, j, k, pass;
+
+    free_terms();
+    npairs = 0;
+    maxpairs = 16 * nobjs + 16;
+    if ((pairs = (struct ls_pair *) malloc(maxpairs * sizeof(struct ls_pair))) == NULL)
+	return;
+    for (i = 0; i < nobjs; i++)
+	for (pass = 0; pass < 3; pass++) {
+	    s = pass == 0 ? objs[i].name : pass == 1 ? objs[i].libname : objs[i].comments;
+	    while (next_word(&s, word, sizeof(word)) > 0) {
+		if (npairs >= maxpairs) {
+		    maxpairs *= 2;
+		    p = (struct ls_pair *) realloc(pairs, maxpairs * sizeof(struct ls_pair));
+		    if (p == NULL)
+			goto done;
+		    pairs = p;
+		}
+		if ((pairs[npairs].word = strdup(word)) == NULL)
+		    goto done;
+		pairs[npairs++].id = i;
+	    }
+	}
+  done:
+    qsort(pairs, npairs, sizeof(struct ls_pair), pair_comp);
+
+    /* count the distinct words */
+    for (i = 0, k = 0; i < npairs; i++)
+	if (i == 0 || strcmp(pairs[i].word, pairs[i-1].word) != 0)
+	    k++;
+    if ((terms = (struct ls_term *) malloc((k + 1) * sizeof(struct ls_term))) != NULL) {
+	for (i = 0; i < npairs; i = j) {
+	    /* pairs i..j-1 have the same word */
+	    for (j = i + 1; j < npairs && strcmp(pairs[j].word, pairs[i].word) == 0; j++)
+		;
+	    terms[nterms].word = pairs[i].word;
+	    pairs[i].word = NULL;
+	    terms[nterms].ids = (int *) malloc((j - i) * sizeof(int));
+	    terms[nterms].nids = 0;
+	    if (terms[nterms].ids == NULL) {
+		free(terms[nterms].word);
+		continue;
+	    }
+	    for (k = i; k < j; k++)
+		/* an object may have the same word more than once */
+		if (k == i || pairs[k].id != pairs[k-1].id)
+		    terms[nterms].ids[terms[nterms].nids++] = pairs[k].id;
+	    nterms++;
+	}
+    }
+    for (i = 0; i < npairs; i++)
+	free(pairs[i].word);
+    free(pairs);
+    if (appres.DEBUG)
+	fprintf(stderr,"Library search: %d objects, %d words\n", nobjs, nterms);
+}
+
+static void
+free_terms(void)
+{
+    int		    i;
+
+    for (i = 0; i < nterms; i++) {
+	free(terms[i].word);
+	free(terms[i].ids);
+    }
+    free(terms);
+    terms = NULL;
+    nterms = 0;
+}
+
+static int
+pair_comp(const void *p1, const void *p2)
+{
+    const struct ls_pair *a = (const struct ls_pair *) p1;
+    const struct ls_pair *b = (const struct ls_pair *) p2;
+    int		    c;
+
+    if ((c = strcmp(a->word, b->word)) != 0)
+	return c;
+    return a->id - b->id;
+}
+
+/*
+ * Copy the next word (run of letters and digits) from *s to word in lower
+ * case, advancing *s past it.  Returns its length, 0 at the end of *s.
+ */
+
+static int
+next_word(char **s, char *word, int size)
+{
+    unsigned char  *c = (unsigned char *) *s;
+    int		    len;
+
+    while (*c && !isalnum(*c))
+	c++;
+    for (len = 0; *c && isalnum(*c); c++)
+	if (len < size - 1)
+	    word[len++] = tolower(*c);
+    word[len] = '\0';
+    *s = (char *) c;
+    return len;
+}
+
+/* return the comment lines of a .fig file, without the "#" */
+
+static char *
+read_fig_comments(char *file)
+{
+    FILE	   *fp;
+    char	    line[256], *comments, *c;
+    int		    len, n, lineno;
+    Boolean	    at_start, in_comment;
+
+    if ((comments = malloc(MAX_LIB_COMMENTS + 1)) == NULL)
+	return NULL;
+    comments[0] = '\0';
+    if ((fp = fopen(file, "r")) == NULL)
+	return comments;
+    len = 0;
+    lineno = 0;
+    at_start = True;
+    in_comment = False;
+    /* a line longer than the buffer is read in pieces */
+    while (fgets(line, sizeof(line), fp) != NULL) {
+	c = line;
+	if (at_start) {
+	    lineno++;
+	    in_comment = line[0] == '#';
+	    if (in_comment)
+		for (c = &line[1]; *c == ' '; c++)
+		    ;
+	}
+	n = strlen(c);
+	at_start = n > 0 && c[n-1] == '\n';
+	/* skip the "#FIG 3.2" line */
+	if (!in_comment || lineno == 1)
+	    continue;
+	if (len + n > MAX_LIB_COMMENTS)
+	    break;
+	strcpy(&comments[len], c);
+	len += n;
+    }
+    fclose(fp);
+    return comments;
+}
+
+static struct libsearch_obj *
+new_obj(void)
+{
+    struct libsearch_obj *o;
+    int		   *ch;
+
+    if (nobjs >= maxobjs) {
+	maxobjs = maxobjs ? 2 * maxobjs : 256;
+	o = (struct libsearch_obj *) realloc(objs, maxobjs * sizeof(struct libsearch_obj));
+	ch = (int *) realloc(obj_chain, maxobjs * sizeof(int));
+	if (o)
+	    objs = o;
+	if (ch)
+	    obj_chain = ch;
+	if (o == NULL || ch == NULL) {
+	    maxobjs = nobjs;
+	    return NULL;
+	}
+    }
+    o = &objs[nobjs++];
+    memset(o, 0, sizeof(struct libsearch_obj));
+    return o;
+}
+
+static unsigned int
+obj_hashval(char *dir, char *name)
+{
+    unsigned int    h;
+
+    for (h = 0; *dir; dir++)
+	h = h * 31 + (unsigned char) *dir;
+    for ( ; *name; name++)
+	h = h * 31 + (unsigned char) *name;
+    return h % OBJ_HASH_SIZE;
+}
+
+static void
+hash_obj(int i)
+{
+    unsigned int    h;
+
+    h = obj_hashval(objs[i].dir, objs[i].name);
+    obj_chain[i] = obj_hash[h];
+    obj_hash[h] = i;
+}
+
+static char *
+search_file_name(void)
+{
+    static char	    name[PATH_MAX];
+
+    if (appres.library_cache_dir == NULL || appres.library_cache_dir[0] == '\0' ||
+	strlen(appres.library_cache_dir) + strlen(LIBSEARCH_FILE) + 2 > PATH_MAX)
+	    return NULL;
+    sprintf(name, "%s/%s", appres.library_cache_dir, LIBSEARCH_FILE);
+    return name;
+}
+
+/*
+ * The search file has, after the magic line, for each object:
+ *	directory
+ *	library name
+ *	object name
+ *	mtime size comment-length
+ *	comment bytes, newline
+ */
+
+static void
+read_search_file(void)
+{
+    struct libsearch_obj *o;
+    FILE	   *fp;
+    char	   *file, line[3][PATH_MAX+2], *c;
+    long	    mtime, size, clen;
+    int		    i;
+
+    if ((file = search_file_name()) == NULL || (fp = fopen(file, "rb")) == NULL)
+	return;
+    if (fgets(line[0], sizeof(line[0]), fp) == NULL || strcmp(line[0], LIBSEARCH_MAGIC) != 0) {
+	fclose(fp);
+	return;
+    }
+    for (;;) {
+	for (i = 0; i < 3; i++) {
+	    if (fgets(line[i], sizeof(line[i]), fp) == NULL ||
+		(c = strchr(line[i], '\n')) == NULL)
+		    break;
+	    *c = '\0';
+	}
+	if (i < 3 || fscanf(fp, "%ld %ld %ld", &mtime, &size, &clen) != 3 ||
+	    getc(fp) != '\n' || clen < 0 || clen > MAX_LIB_COMMENTS ||
+	    (o = new_obj()) == NULL)
+		break;
+	o->dir = strdup(line[0]);
+	o->libname = strdup(line[1]);
+	o->name = strdup(line[2]);
+	o->mtime = (time_t) mtime;
+	o->size = (off_t) size;
+	if ((o->comments = malloc(clen + 1)) == NULL ||
+	    fread(o->comments, 1, clen, fp) != clen || getc(fp) != '\n') {
+		/* a bad entry, throw it away (libsearch_end() drops incomplete objects) */
+		free(o->comments);
+		o->comments = NULL;
+		break;
+	}
+	o->comments[clen] = '\0';
+    }
+    fclose(fp);
+}
+
+static void
+write_search_file(void)
+{
+    struct libsearch_obj *o;
+    FILE	   *fp;
+    char	   *file, tmpname[PATH_MAX+16];
+    int		    i;
+    Boolean	    ok;
+
+    if ((file = search_file_name()) == NULL || !make_cache_dir(appres.library_cache_dir))
+	return;
+    sprintf(tmpname, "%s.%d", file, (int) getpid());
+    if ((fp = fopen(tmpname, "wb")) == NULL)
+	return;
+    ok = fputs(LIBSEARCH_MAGIC, fp) >= 0;
+    for (i = 0; ok && i < nobjs; i++) {
+	o = &objs[i];
+	if (strchr(o->dir, '\n') || strchr(o->libname, '\n') || strchr(o->name, '\n'))
+	    continue;
+	ok = fprintf(fp, "%s\n%s\n%s\n%ld %ld %ld\n", o->dir, o->libname, o->name,
+			(long) o->mtime, (long) o->size, (long) strlen(o->comments)) > 0 &&
+		fwrite(o->comments, 1, strlen(o->comments), fp) == strlen(o->comments) &&
+		putc('\n', fp) != EOF;
+    }
+    if (fclose(fp) != 0)
+	ok = False;
+    if (!ok || rename(tmpname, file) != 0)
+	unlink(tmpname);
+}
@@ -0,0 +1,41 @@
+/*
+ * FIG : Facility for Interactive Generation of figures
+ * Copyright (c) 1985-1988 by Supoj Sutanthavibul
+ * Parts Copyright (c) 1989-2007 by Brian V. Smith
+ *
+ * Any party obtaining a copy of these files is granted, free of charge, a
+ * full and unrestricted irrevocable, world-wide, paid up, royalty-free,
+ * nonexclusive right and license to deal in this software and documentation
+ * files (the "Software"), including without limitation the rights to use,
+ * copy, modify, merge, publish distribute, sublicense and/or sell copies of
+ * the Software, and to permit persons who receive copies from any such
+ * party to do so, with the only requirement being that the above copyright
+ * and this permission notice remain intact.
+ *
+ */
+
+#ifndef F_LIBSEARCH_H
+#define F_LIBSEARCH_H
+
+/*
+ * Word index over the names, library names and comments of the objects
+ * in all libraries, kept in the library cache directory.
+ */
+
+struct libsearch_obj {
+    char	   *dir;		/* library directory */
+    char	   *libname;		/* long name of the library */
+    char	   *name;		/* object name (file name without .fig) */
+    time_t	    mtime;		/* modification time of the .fig file */
+    off_t	    size;		/* and its size */
+    char	   *comments;		/* comment lines of the .fig file */
+    void	   *library;		/* library record of the caller (not saved) */
+    Boolean	    seen;		/* found in the last scan */
+};
+
+extern void	libsearch_begin(void);
+extern int	libsearch_add_dir(char *dir, char *libname, void *library);
+extern void	libsearch_end(void);
+extern int	libsearch_query(char *query, struct libsearch_obj ***hits);
+
+#endif /* F_LIBSEARCH_H */
@@ -40,6 +40,7 @@
 #include "u_draw.h"
 #include "u_list.h"
 #include "u_redraw.h"
+#include "u_timing.h"
 #include "w_cursor.h"
 #include "w_grid.h"
 
@@ -75,6 +76,7 @@ load_file(char *file, int xoff, int yoff)
     c.texts = NULL;
     c.comments = NULL;
     c.next = NULL;
+    clear_last_objects(&c);
     set_temp_cursor(wait_cursor);
 
     /* initialize the active_layers array */
@@ -85,6 +87,7 @@ load_file(char *file, int xoff, int yoff)
     clearallcounts();
 
     s = read_figc(file, &c, DONT_MERGE, REMAP_IMAGES, xoff, yoff, &settings);
+    timing_phase("reading the figure");
     defer_update_layers = 1;	/* so update_layers() won't update for each object */
     add_compound_depth(&c);	/* count objects at each depth */
     defer_update_layers = 0;
@@ -98,6 +101,8 @@ load_file(char *file, int xoff, int yoff)
 	close_all_compounds();
 	saved_objects = objects;
 	objects = c;
+	/* the figure lists have been replaced, forget what was indexed for them */
+	clear_last_objects(&objects);
 
 	/* update the settings in appres.xxx from the settings struct returned from read_fig */
 	update_settings(&settings);
@@ -124,6 +129,8 @@ load_file(char *file, int xoff, int yoff)
 	clean_up();
 	saved_objects = objects;
 	objects = c;
+	/* the figure lists have been replaced, forget what was indexed for them */
+	clear_last_objects(&objects);
 	redisplay_canvas();
 	put_msg("Current figure \"%s\" (new file)", file);
 	(void) strcpy(save_filename, cur_filename);
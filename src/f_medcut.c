@@ -0,0 +1,310 @@
+/*
+ * FIG : Facility for Interactive Generation of figures
+ * Copyright (c) 1985-1988 by Supoj Sutanthavibul
+ * Parts Copyright (c) 1989-2007 by Brian V. Smith
+ *
+ * Any party obtaining a copy of these files is granted, free of charge, a
+ * full and unrestricted irrevocable, world-wide, paid up, royalty-free,
+ * nonexclusive right and license to deal in this software and documentation
+ * files (the "Software"), including without limitation the rights to use,
+ * copy, modify, merge, publish distribute, sublicense and/or sell copies of
+ * the Software, and to permit persons who receive copies from any such
+ * party to do so, with the only requirement being that the above copyright
+ * and this permission notice remain intact.
+ *
+ */
+
+/*
+ * Median-cut color quantization (after Heckbert, "Color Image Quantization
+ * for Frame Buffer Display", SIGGRAPH 1982).
+ *
+ * Colors are counted in a histogram with 5 bits per primary.  The box
+ * holding all the colors is split repeatedly at the median of its longest
+ * side until there are as many boxes as colors wanted, and the mean color
+ * of each box goes into clrtab[][].  Pixels are then mapped with a table
+ * giving the nearest clrtab entry for each histogram cell, filled in as
+ * cells are first looked up.
+ *
+ * Because the histogram may be fed with weighted colors, a set of pictures
+ * can be quantized from their colormaps and color counts alone.
+ */
+
+#include "fig.h"
+#include "resources.h"
+#include "object.h"
+#include "f_medcut.h"
+
+#include <limits.h>	/* LONG_MAX */
+
+#define MC_BITS		5
+#define MC_SIDE		(1 << MC_BITS)
+#define MC_CELLS	(MC_SIDE * MC_SIDE * MC_SIDE)
+#define MC_SHIFT	(8 - MC_BITS)
+
+/* histogram cell for an 8-bit red, green, blue triple */
+#define MC_CELL(r,g,b)	((((r) >> MC_SHIFT) << (2*MC_BITS)) | \
+			 (((g) >> MC_SHIFT) << MC_BITS) | ((b) >> MC_SHIFT))
+
+struct mc_cell {
+    unsigned long   count;
+    unsigned long   sum[3];		/* sums of the red, green, blue values */
+};
+
+struct mc_box {
+    int		    lo[3], hi[3];	/* cell bounds (inclusive) in red, green, blue */
+    unsigned long   count;		/* number of pixels in the box */
+};
+
+static struct mc_cell *hist = NULL;
+static short	      *inverse = NULL;	/* clrtab index of each cell, -1 if not found yet */
+static int	       ncolors_made = 0;
+
+static void	shrink_box(struct mc_box *box);
+static void	split_box(struct mc_box *box, struct mc_box *newbox);
+static int	nearest_color(int cell);
+
+/* clear the histogram; returns -1 if there is no memory for it */
+
+int
+mcut_init(void)
+{
+    if (hist == NULL) {
+	hist = (struct mc_cell *) malloc(MC_CELLS * sizeof(struct mc_cell));
+	inverse = (short *) malloc(MC_CELLS * sizeof(short));
+	if (hist == NULL || inverse == NULL) {
+	    free(hist);
+	    free(inverse);
+	    hist = NULL;
+	    inverse = NULL;
+	    return -1;
+	}
+    }
+    memset(hist, 0, MC_CELLS * sizeof(struct mc_cell));
+    ncolors_made = 0;
+    return 0;
+}
+
+/* add count pixels of color col to the histogram */
+
+void
+mcut_add(BYTE *col, unsigned long count)
+{
+    struct mc_cell *c;
+
+    c = &hist[MC_CELL(col[N_RED], col[N_GRN], col[N_BLU])];
+    c->count += count;
+    c->sum[N_RED] += count * col[N_RED];
+    c->sum[N_GRN] += count * col[N_GRN];
+    c->sum[N_BLU] += count * col[N_BLU];
+}
+
+/* add npix pixels stored as blue, green, red byte triples */
+
+void
+mcut_add_pixels(unsigned char *bgr, long npix)
+{
+    struct mc_cell *c;
+    unsigned int    r, g, b;
+
+    for ( ; npix > 0; npix--, bgr += 3) {
+	b = bgr[0];
+	g = bgr[1];
+	r = bgr[2];
+	c = &hist[MC_CELL(r, g, b)];
+	c->count++;
+	c->sum[N_RED] += r;
+	c->sum[N_GRN] += g;
+	c->sum[N_BLU] += b;
+    }
+}
+
+/* make a colormap of at most ncolors colors in clrtab[][]; returns the number made */
+
+int
+mcut_clrtab(int ncolors)
+{
+    struct mc_box  *boxes;
+    unsigned long   sum[3], count;
+    int		    nboxes, best, i, v[3], c;
+
+    if (ncolors > 256)
+	ncolors = 256;
+    if (ncolors < 1 || (boxes = (struct mc_box *)
+			malloc(ncolors * sizeof(struct mc_box))) == NULL)
+	return 0;
+
+    for (i = 0; i < 3; i++) {
+	boxes[0].lo[i] = 0;
+	boxes[0].hi[i] = MC_SIDE-1;
+    }
+    shrink_box(&boxes[0]);
+    nboxes = boxes[0].count? 1: 0;
+
+    while (nboxes < ncolors) {
+	/* split the most populated box that has more than one cell */
+	best = -1;
+	for (i = 0; i < nboxes; i++)
+	    if ((boxes[i].lo[0] < boxes[i].hi[0] || boxes[i].lo[1] < boxes[i].hi[1] ||
+			boxes[i].lo[2] < boxes[i].hi[2]) &&
+			(best < 0 || boxes[i].count > boxes[best].count))
+		best = i;
+	if (best < 0)
+	    break;
+	split_box(&boxes[best], &boxes[nboxes]);
+	nboxes++;
+    }
+
+    /* the color of each box is the mean of the colors in it */
+    for (i = 0; i < nboxes; i++) {
+	sum[0] = sum[1] = sum[2] = count = 0;
+	for (v[0] = boxes[i].lo[0]; v[0] <= boxes[i].hi[0]; v[0]++)
+	    for (v[1] = boxes[i].lo[1]; v[1] <= boxes[i].hi[1]; v[1]++)
+		for (v[2] = boxes[i].lo[2]; v[2] <= boxes[i].hi[2]; v[2]++) {
+		    c = (v[0] << (2*MC_BITS)) | (v[1] << MC_BITS) | v[2];
+		    count += hist[c].count;
+		    sum[0] += hist[c].sum[N_RED];
+		    sum[1] += hist[c].sum[N_GRN];
+		    sum[2] += hist[c].sum[N_BLU];
+		}
+	clrtab[i][N_RED] = (BYTE) ((sum[0] + count/2) / count);
+	clrtab[i][N_GRN] = (BYTE) ((sum[1] + count/2) / count);
+	clrtab[i][N_BLU] = (BYTE) ((sum[2] + count/2) / count);
+    }
+    free(boxes);
+
+    /* forget any previous mapping */
+    for (i = 0; i < MC_CELLS; i++)
+	inverse[i] = -1;
+    ncolors_made = nboxes;
+    return nboxes;
+}
+
+/* return the clrtab index of the color nearest col */
+
+int
+mcut_map_pixel(BYTE *col)
+{
+    int		    cell;
+
+    cell = MC_CELL(col[N_RED], col[N_GRN], col[N_BLU]);
+    if (inverse[cell] < 0)
+	return nearest_color(cell);
+    return inverse[cell];
+}
+
+/* map npix blue, green, red byte triples to clrtab indices in out */
+
+void
+mcut_map_pixels(unsigned char *bgr, unsigned char *out, long npix)
+{
+    int		    cell;
+
+    for ( ; npix > 0; npix--, bgr += 3) {
+	cell = MC_CELL(bgr[2], bgr[1], bgr[0]);
+	if (inverse[cell] < 0)
+	    nearest_color(cell);
+	*out++ = (unsigned char) inverse[cell];
+    }
+}
+
+/* make the bounds of box as tight as possible and count its pixels */
+
+static void
+shrink_box(struct mc_box *box)
+{
+    int		    lo[3], hi[3], v[3], i, c;
+    unsigned long   count;
+
+    for (i = 0; i < 3; i++) {
+	lo[i] = MC_SIDE;
+	hi[i] = -1;
+    }
+    count = 0;
+    for (v[0] = box->lo[0]; v[0] <= box->hi[0]; v[0]++)
+	for (v[1] = box->lo[1]; v[1] <= box->hi[1]; v[1]++)
+	    for (v[2] = box->lo[2]; v[2] <= box->hi[2]; v[2]++) {
+		c = (v[0] << (2*MC_BITS)) | (v[1] << MC_BITS) | v[2];
+		if (hist[c].count == 0)
+		    continue;
+		count += hist[c].count;
+		for (i = 0; i < 3; i++) {
+		    if (v[i] < lo[i])
+			lo[i] = v[i];
+		    if (v[i] > hi[i])
+			hi[i] = v[i];
+		}
+	    }
+    box->count = count;
+    if (count == 0)
+	return;
+    for (i = 0; i < 3; i++) {
+	box->lo[i] = lo[i];
+	box->hi[i] = hi[i];
+    }
+}
+
+/*
+ * Split box at the median of its longest side, putting the upper part in
+ * newbox.  The box must have been shrunk, so both parts get some pixels.
+ */
+
+static void
+split_box(struct mc_box *box, struct mc_box *newbox)
+{
+    unsigned long   proj[MC_SIDE], acc;
+    int		    axis, i, s, v[3], c;
+
+    axis = 0;
+    for (i = 1; i < 3; i++)
+	if (box->hi[i] - box->lo[i] > box->hi[axis] - box->lo[axis])
+	    axis = i;
+
+    /* count the pixels in each plane across the axis */
+    for (i = 0; i < MC_SIDE; i++)
+	proj[i] = 0;
+    for (v[0] = box->lo[0]; v[0] <= box->hi[0]; v[0]++)
+	for (v[1] = box->lo[1]; v[1] <= box->hi[1]; v[1]++)
+	    for (v[2] = box->lo[2]; v[2] <= box->hi[2]; v[2]++) {
+		c = (v[0] << (2*MC_BITS)) | (v[1] << MC_BITS) | v[2];
+		proj[v[axis]] += hist[c].count;
+	    }
+
+    s = box->lo[axis];
+    acc = proj[s];
+    while (s < box->hi[axis]-1 && acc < box->count/2)
+	acc += proj[++s];
+
+    *newbox = *box;
+    newbox->lo[axis] = s+1;
+    box->hi[axis] = s;
+    shrink_box(box);
+    shrink_box(newbox);
+}
+
+/* find the clrtab entry nearest the center of a histogram cell */
+
+static int
+nearest_color(int cell)
+{
+    int		    r, g, b, dr, dg, db, i, best;
+    long	    d, bestd;
+
+    r = (((cell >> (2*MC_BITS)) & (MC_SIDE-1)) << MC_SHIFT) | (1 << (MC_SHIFT-1));
+    g = (((cell >> MC_BITS) & (MC_SIDE-1)) << MC_SHIFT) | (1 << (MC_SHIFT-1));
+    b = ((cell & (MC_SIDE-1)) << MC_SHIFT) | (1 << (MC_SHIFT-1));
+
+    best = 0;
+    bestd = LONG_MAX;
+    for (i = 0; i < ncolors_made; i++) {
+	dr = r - clrtab[i][N_RED];
+	dg = g - clrtab[i][N_GRN];
+	db = b - clrtab[i][N_BLU];
+	d = (long) dr*dr + (long) dg*dg + (long) db*db;
+	if (d < bestd) {
+	    bestd = d;
+	    best = i;
+	}
+    }
+    inverse[cell] = (short) best;
+    return best;
+}
@@ -0,0 +1,35 @@
+/*
+ * FIG : Facility for Interactive Generation of figures
+ * Copyright (c) 1985-1988 by Supoj Sutanthavibul
+ * Parts Copyright (c) 1989-2007 by Brian V. Smith
+ *
+ * Any party obtaining a copy of these files is granted, free of charge, a
+ * full and unrestricted irrevocable, world-wide, paid up, royalty-free,
+ * nonexclusive right and license to deal in this software and documentation
+ * files (the "Software"), including without limitation the rights to use,
+ * copy, modify, merge, publish distribute, sublicense and/or sell copies of
+ * the Software, and to permit persons who receive copies from any such
+ * party to do so, with the only requirement being that the above copyright
+ * and this permission notice remain intact.
+ *
+ */
+
+#ifndef F_MEDCUT_H
+#define F_MEDCUT_H
+
+/*
+ * Median-cut color quantization on a 5-5-5 bit color histogram.
+ * The resulting colormap is put in clrtab[][] (see f_neuclrtab.h) so
+ * callers can use it the same way as the one from the neural net.
+ */
+
+#include "f_neuclrtab.h"
+
+extern int  mcut_init(void);
+extern void mcut_add(BYTE *col, unsigned long count);
+extern void mcut_add_pixels(unsigned char *bgr, long npix);
+extern int  mcut_clrtab(int ncolors);
+extern int  mcut_map_pixel(BYTE *col);
+extern void mcut_map_pixels(unsigned char *bgr, unsigned char *out, long npix);
+
+#endif /* F_MEDCUT_H */
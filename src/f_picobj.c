@@ -34,6 +34,7 @@
 
 #include "w_file.h"
 #include "w_util.h"
+#include "u_timing.h"
 
 extern	int	read_gif(FILE *file, int filetype, F_pic *pic);
 extern	int	read_pcx(FILE *file, int filetype, F_pic *pic);
@@ -81,6 +82,11 @@ static	 struct hdr {
 
 #define NUMHEADERS sizeof(headers)/sizeof(headers[0])
 
+static Boolean	read_picfile(F_pic *pic, char *file);
+static void	evict_pic_bitmaps(struct _pics *keep);
+
+static unsigned long	pic_bitmap_gen = 0;
+
 /*
  * Check through the pictures repository to see if "file" is already there.
  * If so, set the pic->pic_cache pointer to that repository entry and set
@@ -94,13 +100,10 @@ static	 struct hdr {
 
 void read_picobj(F_pic *pic, char *file, int color, Boolean force, Boolean *existing)
 {
-    FILE	   *fd;
-    int		    type;
-    int		    i,j,c;
-    char	    buf[20],realname[PATH_MAX];
-    Boolean	    found, reread;
+    Boolean	    reread, ok;
     struct _pics   *pics, *lastpic;
     time_t	    mtime;
+    double	    start;
 
     pic->color = color;
     /* don't touch the flipped flag - caller has already set it */
@@ -141,8 +144,9 @@ void read_picobj(F_pic *pic, char *file, int color, Boolean force, Boolean *exis
 	    pics->refcount++;
 	    if (appres.DEBUG)
 		fprintf(stderr,"Found stored picture %s, count=%d\n",file,pics->refcount);
-	    /* if there is a bitmap, return, otherwise fall through and reread the file */
-	    if (pics->bitmap != NULL) {
+	    /* if there is a bitmap (or it was only evicted), return,
+	       otherwise fall through and reread the file */
+	    if (PIC_PRESENT(pics)) {
 		*existing = True;
 		put_msg("Reading Picture object file...found cached picture");
 		/* must set the h/w ratio here */
@@ -185,15 +189,45 @@ void read_picobj(F_pic *pic, char *file, int color, Boolean force, Boolean *exis
     /* put it in the pic */
     pic->pic_cache = pics;
     pic->pixmap = (Pixmap) NULL;
+    /* any reduced copies, color counts and pixels are of the old bitmap */
+    free_pic_levels(pics);
+    pics->bitmap_gen = ++pic_bitmap_gen;
+    pics->rgb = False;
+    pics->evicted = False;
+
+    start = timing_now();
+    ok = read_picfile(pic, file);
+    timing_add("reading pictures", start);
+    if (ok)
+	/* make room for the new bitmap */
+	evict_pic_bitmaps(pics);
+}
+
+/*
+ * Read picture file "file" into pic->pic_cache with the reader for its
+ * format.  Returns False if the file can't be opened or read.
+ */
+
+static Boolean
+read_picfile(F_pic *pic, char *file)
+{
+    FILE	   *fd;
+    int		    type;
+    int		    i,j,c;
+    char	    buf[20],realname[PATH_MAX];
+    Boolean	    found, ok;
+    struct _pics   *pics = pic->pic_cache;
 
     /* open the file and read a few bytes of the header to see what it is */
     if ((fd=open_picfile(file, &type, PIPEOK, realname)) == NULL) {
 	file_msg("No such picture file: %s",file);
-	return;
+	return False;
     }
     /* get the modified time and save it */
     pics->time_stamp = file_timestamp(file);
     /* and save the realname (it may be compressed) */
+    if (pics->realname)
+	free(pics->realname);
     pics->realname = strdup(realname);
 
     /* read some bytes from the file */
@@ -216,26 +250,338 @@ void read_picobj(F_pic *pic, char *file, int color, Boolean force, Boolean *exis
 	    break;
     }
     if (found) {
+	ok = True;
 	if (headers[i].pipeok) {
 	    /* open it again (it may be a pipe so we can't just rewind) */
 	    fd=open_picfile(file, &type, headers[i].pipeok, realname);
 	    if ( (*headers[i].readfunc)(fd,type,pic) == FileInvalid) {
 		file_msg("%s: Bad %s format",file, headers[i].type);
+		ok = False;
 	    }
 	} else {
 	    /* those routines that can't take a pipe (e.g. xpm) get the real filename */
 	    if ( (*headers[i].readfunc)(realname,type,pic) == FileInvalid) {
 		file_msg("%s: Bad %s format",file, headers[i].type);
+		ok = False;
 	    }
 	}
 	put_msg("Reading Picture object file...Done");
-	return;
+	return ok;
     }
 
     /* none of the above */
     file_msg("%s: Unknown image format",file);
     put_msg("Reading Picture object file...Failed");
     app_flush();
+    return False;
+}
+
+/*
+ * Reduced-size copies ("levels") of picture bitmaps.
+ *
+ * When a picture is displayed much smaller than its bitmap, the pixmap is
+ * scaled from the smallest level that is still at least as large as the
+ * display size instead of from the full bitmap.  Level k is the bitmap
+ * reduced by 2^k in each direction, level 0 is the bitmap itself.
+ * The levels are made when first needed, each from the one before, and
+ * their total size is kept below the pic_level_budget resource (kbytes)
+ * by freeing the least recently used ones.
+ */
+
+static unsigned long	pic_level_clock = 0;
+static long		pic_level_bytes = 0;	/* memory used by all levels k >= 1 */
+
+/*
+ * Halve bitmap "src" of size sw x sh to dw x dh, taking every other pixel.
+ * ps is the number of bytes per pixel, 0 for a 1-bit bitmap.
+ */
+
+static char *
+reduce_bitmap(char *src, int sw, int sh, int ps, int dw, int dh)
+{
+    unsigned char  *dst, *srow, *drow;
+    int		    i, j, sx, sbytes, dbytes;
+
+    if (ps == 0) {
+	sbytes = (sw + 7) / 8;
+	dbytes = (dw + 7) / 8;
+	if ((dst = (unsigned char *) calloc(dbytes, dh)) == NULL)
+	    return NULL;
+	for (j = 0; j < dh; j++) {
+	    srow = (unsigned char *) src + 2 * j * sbytes;
+	    drow = dst + j * dbytes;
+	    for (i = 0; i < dw; i++) {
+		sx = 2 * i;
+		if (srow[sx >> 3] & (0x80 >> (sx & 7)))
+		    drow[i >> 3] |= 0x80 >> (i & 7);
+	    }
+	}
+    } else if (ps == 3) {
+	if ((dst = (unsigned char *) malloc(3 * dw * dh)) == NULL)
+	    return NULL;
+	for (j = 0; j < dh; j++) {
+	    srow = (unsigned char *) src + 2 * j * 3 * sw;
+	    drow = dst + j * 3 * dw;
+	    for (i = 0; i < dw; i++, drow += 3) {
+		drow[0] = srow[6 * i];
+		drow[1] = srow[6 * i + 1];
+		drow[2] = srow[6 * i + 2];
+	    }
+	}
+    } else {
+	if ((dst = (unsigned char *) malloc(dw * dh)) == NULL)
+	    return NULL;
+	for (j = 0; j < dh; j++) {
+	    srow = (unsigned char *) src + 2 * j * sw;
+	    drow = dst + j * dw;
+	    for (i = 0; i < dw; i++)
+		drow[i] = srow[2 * i];
+	}
+    }
+    return (char *) dst;
+}
+
+/* free least recently used levels until we are within the budget */
+
+static void
+evict_pic_levels(struct _pics *keep, int keepk)
+{
+    struct _pics   *pics, *oldest;
+    long	    budget;
+    int		    k, oldk;
+
+    budget = (long) appres.pic_level_budget * 1024;
+    if (budget <= 0)
+	return;
+
+    while (pic_level_bytes > budget) {
+	oldest = NULL;
+	oldk = 0;
+	for (pics = pictures; pics; pics = pics->next)
+	    for (k = 1; k < pics->nlevels; k++) {
+		if (pics->levels[k].bitmap == NULL || (pics == keep && k == keepk))
+		    continue;
+		if (oldest == NULL ||
+		    pics->levels[k].last_use < oldest->levels[oldk].last_use) {
+			oldest = pics;
+			oldk = k;
+		}
+	    }
+	if (oldest == NULL)
+	    break;
+	if (appres.DEBUG)
+	    fprintf(stderr,"Evict level %d (%dx%d) of picture %s\n", oldk,
+			oldest->levels[oldk].bit_size.x,
+			oldest->levels[oldk].bit_size.y, oldest->file);
+	pic_level_bytes -= oldest->levels[oldk].bytes;
+	free(oldest->levels[oldk].bitmap);
+	oldest->levels[oldk].bitmap = NULL;
+    }
+}
+
+/*
+ * Return the bitmap of the smallest level of picture "pics" that is at
+ * least want_x by want_y pixels (the full bitmap if no smaller one is)
+ * and put its size in "size".
+ */
+
+char *
+pic_level_bitmap(struct _pics *pics, int want_x, int want_y, F_pos *size)
+{
+    struct _piclevel *cur, *next;
+    int		    k, nx, ny, ps;
+
+    /* levels made from an older bitmap are no good */
+    if (pics->nlevels > 0 && pics->levels_of != pics->bitmap)
+	free_pic_levels(pics);
+    if (pics->nlevels == 0) {
+	pics->levels[0].bitmap = pics->bitmap;
+	pics->levels[0].bit_size = pics->bit_size;
+	pics->nlevels = 1;
+	pics->levels_of = pics->bitmap;
+    }
+    ps = pics->rgb ? 3 : pics->numcols == 0 ? 0 : 1;
+
+    for (k = 0; k < MAX_PIC_LEVELS - 1; k++) {
+	cur = &pics->levels[k];
+	nx = (cur->bit_size.x + 1) / 2;
+	ny = (cur->bit_size.y + 1) / 2;
+	if (nx < want_x || ny < want_y ||
+	    (cur->bit_size.x == 1 && cur->bit_size.y == 1))
+		break;
+	next = &pics->levels[k+1];
+	if (k+1 >= pics->nlevels || next->bitmap == NULL) {
+	    next->bitmap = reduce_bitmap(cur->bitmap, cur->bit_size.x,
+				cur->bit_size.y, ps, nx, ny);
+	    if (next->bitmap == NULL)
+		break;
+	    next->bit_size.x = nx;
+	    next->bit_size.y = ny;
+	    next->bytes = ps == 0 ? (long) (nx + 7) / 8 * ny : (long) nx * ny * ps;
+	    if (k+1 >= pics->nlevels)
+		pics->nlevels = k+2;
+	    pic_level_bytes += next->bytes;
+	    if (appres.DEBUG)
+		fprintf(stderr,"Made level %d (%dx%d) of picture %s\n",
+				k+1, nx, ny, pics->file);
+	}
+    }
+    pics->levels[k].last_use = ++pic_level_clock;
+    *size = pics->levels[k].bit_size;
+    evict_pic_levels(pics, k);
+    return pics->levels[k].bitmap;
+}
+
+/* free the reduced levels of picture "pics", e.g. when its bitmap changes */
+
+void
+free_pic_levels(struct _pics *pics)
+{
+    int		    k;
+
+    for (k = 1; k < pics->nlevels; k++)
+	if (pics->levels[k].bitmap) {
+	    pic_level_bytes -= pics->levels[k].bytes;
+	    free(pics->levels[k].bitmap);
+	    pics->levels[k].bitmap = NULL;
+	}
+    pics->nlevels = 0;
+    pics->levels_of = NULL;
+}
+
+/*
+ * Evicted picture bitmaps.
+ *
+ * The full bitmaps of all pictures are kept below the pic_memory_budget
+ * resource (kbytes) by freeing the bitmaps of the pictures drawn least
+ * recently, which are usually those off the canvas, on inactive layers or
+ * on other slides.  An evicted picture keeps its size and colormap, so
+ * it still takes part in color allocation, and its bitmap is read from the
+ * file again when a pixmap must be made from it.
+ */
+
+static unsigned long	pic_draw_clock = 0;
+
+/* note that picture "pics" has just been drawn */
+
+void
+pic_drawn(struct _pics *pics)
+{
+    pics->last_drawn = ++pic_draw_clock;
+}
+
+static long
+pic_bitmap_bytes(struct _pics *pics)
+{
+    if (pics->rgb)
+	return (long) pics->bit_size.x * pics->bit_size.y * 3;
+    if (pics->numcols > 0)
+	return (long) pics->bit_size.x * pics->bit_size.y;
+    return (long) (pics->bit_size.x + 7) / 8 * pics->bit_size.y;
+}
+
+/* free least recently drawn bitmaps, except that of "keep", until we are within the budget */
+
+static void
+evict_pic_bitmaps(struct _pics *keep)
+{
+    struct _pics   *pics, *oldest;
+    long	    budget, total;
+
+    budget = (long) appres.pic_memory_budget * 1024;
+    if (budget <= 0)
+	return;
+
+    total = 0;
+    for (pics = pictures; pics; pics = pics->next)
+	if (pics->bitmap != NULL)
+	    total += pic_bitmap_bytes(pics);
+
+    while (total > budget) {
+	oldest = NULL;
+	for (pics = pictures; pics; pics = pics->next) {
+	    if (pics->bitmap == NULL || pics == keep || pics->file[0] == '\0')
+		continue;
+	    if (oldest == NULL || pics->last_drawn < oldest->last_drawn)
+		oldest = pics;
+	}
+	if (oldest == NULL)
+	    break;
+	if (appres.DEBUG)
+	    fprintf(stderr,"Evict bitmap (%dx%d) of picture %s\n",
+			oldest->bit_size.x, oldest->bit_size.y, oldest->file);
+	/* the color counts are needed for quantizing even without the bitmap */
+	if (oldest->numcols > 0 && oldest->colhist_gen != oldest->bitmap_gen)
+	    count_pic_colors(oldest);
+	total -= pic_bitmap_bytes(oldest);
+	free_pic_levels(oldest);
+	free(oldest->bitmap);
+	oldest->bitmap = NULL;
+	oldest->evicted = True;
+    }
+}
+
+/*
+ * Make sure picture "pics" has its bitmap, reading the file again if the
+ * bitmap was evicted.  Returns False if there is no bitmap.
+ */
+
+Boolean
+load_pic_bitmap(struct _pics *pics)
+{
+    static struct Cmap	oldcmap[MAX_COLORMAP_SIZE];
+    F_pic	    pic;
+    F_pos	    oldsize;
+    int		    oldcols, i;
+    Boolean	    oldrgb, same, ok;
+    double	    start;
+
+    if (pics->bitmap != NULL)
+	return True;
+    if (!pics->evicted)
+	return False;
+
+    if (appres.DEBUG)
+	fprintf(stderr,"Re-reading evicted picture %s\n", pics->file);
+    oldsize = pics->bit_size;
+    oldcols = pics->numcols;
+    oldrgb = pics->rgb;
+    memcpy(oldcmap, pics->cmap, oldcols * sizeof(struct Cmap));
+
+    /* the readers only need a picture object that points to the repository entry */
+    memset(&pic, 0, sizeof(pic));
+    pic.pic_cache = pics;
+    pics->evicted = False;
+    pics->rgb = False;
+    start = timing_now();
+    ok = read_picfile(&pic, pics->file);
+    timing_add("reading pictures", start);
+    if (!ok || pics->bitmap == NULL)
+	return False;
+
+    same = pics->bit_size.x == oldsize.x && pics->bit_size.y == oldsize.y &&
+		pics->numcols == oldcols && pics->rgb == oldrgb;
+    for (i = 0; same && i < oldcols; i++)
+	same = pics->cmap[i].red == oldcmap[i].red &&
+		pics->cmap[i].green == oldcmap[i].green &&
+		pics->cmap[i].blue == oldcmap[i].blue;
+    if (same) {
+	/* the same image as before, so the colors already allocated still apply */
+	for (i = 0; i < oldcols; i++)
+	    pics->cmap[i].pixel = oldcmap[i].pixel;
+    } else {
+	/*
+	 * The file has changed since the bitmap was evicted, so its colors
+	 * must be mapped again.  Not in the middle of drawing, though: leave
+	 * this picture out for now and redraw all pictures after the remap.
+	 */
+	pics->bitmap_gen = ++pic_bitmap_gen;
+	remap_imagecolors_later();
+	evict_pic_bitmaps(pics);
+	return False;
+    }
+    evict_pic_bitmaps(pics);
+    return True;
 }
 
 /*
@@ -22,3 +22,7 @@ extern void		 close_picfile(FILE *file, int type);
 #define PIPEOK		True
 #define PIPE_NOTOK	False
 extern void read_picobj (F_pic *pic, char *file, int color, Boolean force, Boolean *existing);
+extern char *pic_level_bitmap (struct _pics *pics, int want_x, int want_y, F_pos *size);
+extern void free_pic_levels (struct _pics *pics);
+extern Boolean load_pic_bitmap (struct _pics *pics);
+extern void pic_drawn (struct _pics *pics);
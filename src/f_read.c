@@ -35,11 +35,13 @@
 #include "w_zoom.h"
 
 #include "d_spline.h"
+#include "d_text.h"
 #include "e_update.h"
 #include "f_picobj.h"
 #include "f_readold.h"
 #include "f_util.h"
 #include "u_bound.h"
+#include "u_draw.h"
 #include "u_free.h"
 #include "u_scale.h"
 #include "u_translate.h"
@@ -413,6 +415,10 @@ readfp_fig(FILE *fp, F_compound *obj, Boolean merge, int xoff, int yoff, fig_set
     if (!update_figs)
 	shift_figure(obj);
 
+    /* get the fonts to draw the texts at the current zoom, all at once */
+    if (!update_figs && display_zoomscale != 1.0)
+	load_text_fonts(obj);
+
     /* now update the grid/ruler units */
     if (settings->units) {
 	/* inches */
@@ -1511,15 +1517,13 @@ read_textobject(FILE *fp)
 
     if (!update_figs) {
 	/* now calculate the actual length and height of the string in fig units */
-	tx_dim = textsize(t->fontstruct, strlen(t->cstring), t->cstring);
+	tx_dim = text_size(t, t->fontstruct);
 	t->length = round(tx_dim.length);
 	t->ascent = round(tx_dim.ascent);
 	t->descent = round(tx_dim.descent);
-	/* now get the zoomed font struct */
-	t->zoom = zoomscale;
-	if (display_zoomscale != 1.0)
-	    t->fontstruct = lookfont(x_fontnum(psfont_text(t), t->font),
-				round(t->size*display_zoomscale));
+	/* the unzoomed font is the one to draw with at zoom 1, otherwise
+	   readfp_fig() loads the zoomed fonts of all texts at the end */
+	t->zoom = display_zoomscale == 1.0? zoomscale: 0.0;
     }
 
     t->comments = attach_comments();		/* attach any comments */
@@ -21,6 +21,7 @@
 #include "f_read.h"
 #include "f_util.h"
 #include "u_create.h"
+#include "u_draw.h"
 #include "u_fonts.h"
 #include "w_drawprim.h"
 #include "w_msgpanel.h"
@@ -514,21 +515,21 @@ read_1_3_textobject(FILE *fp)
 	return (NULL);
     }
 
-    /* get the font struct */
-    t->zoom = zoomscale;
-    t->fontstruct = lookfont(x_fontnum(psfont_text(t), t->font),
-			round(t->size*display_zoomscale));
-
     if (t->font >= MAXFONT(t)) {
 	file_msg("Invalid text font (%d) at line %d, setting to DEFAULT.",
 		t->font, line_no);
 	t->font = DEFAULT;
     }
+    /* get the UNZOOMED font struct */
+    t->fontstruct = lookfont(x_fontnum(psfont_text(t), t->font), t->size);
     /* now calculate the actual length and height of the string in fig units */
-    tx_dim = textsize(t->fontstruct, strlen(t->cstring), t->cstring);
+    tx_dim = text_size(t, t->fontstruct);
     t->length = round(tx_dim.length);
     t->ascent = round(tx_dim.ascent);
     t->descent = round(tx_dim.descent);
+    /* the unzoomed font is the one to draw with at zoom 1, otherwise
+       readfp_fig() loads the zoomed fonts of all texts at the end */
+    t->zoom = display_zoomscale == 1.0? zoomscale: 0.0;
 
     return (t);
 }
@@ -234,7 +234,7 @@ int _read_pcx(FILE *pcxfile, F_pic *pic)
 		break;
 
 	    case 24:
-		/* no palette, must use neural net to reduce to 256 colors with palette */
+		/* no palette, reduce to 256 colors with palette (unless kept as RGB) */
 		if (!map_to_palette(pic))
 		    return FileInvalid;		/* out of memory or something */
 		break;
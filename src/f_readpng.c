@@ -196,12 +196,11 @@ read_png(FILE *file, int filetype, F_pic *pic)
     pic->pic_cache->bit_size.y = h;
 
     if (color_type == PNG_COLOR_TYPE_RGB || color_type == PNG_COLOR_TYPE_RGB_ALPHA) {
-	/* no palette, must use neural net to reduce to 256 colors with palette */
+	/* no palette, reduce to 256 colors with palette (unless kept as RGB) */
 	if (!map_to_palette(pic)) {
 	    close_picfile(file,filetype);
 	    return FileInvalid;		/* out of memory or something */
 	}
-	pic->pic_cache->numcols = 256;
     } else {
 	pic->pic_cache->numcols = num_palette;
     }
@@ -17,10 +17,12 @@
 #include "resources.h"
 #include "object.h"
 #include "mode.h"
+#include "f_medcut.h"
 #include "f_neuclrtab.h"
 #include "f_read.h"
 #include "f_util.h"
 #include "u_create.h"
+#include "u_draw.h"
 #include "w_file.h"
 #include "w_indpanel.h"
 #include "w_color.h"
@@ -46,6 +48,7 @@ int	count_pixels(void);
 void beep (void);
 void alloc_imagecolors (int num);
 void add_all_pixels (void);
+Boolean add_all_colors (void);
 void remap_image_colormap (void);
 void extract_cmap (void);
 void readjust_cmap (void);
@@ -213,11 +216,42 @@ xf_basename(char *filename)
 static int	  scol, ncolors;
 static int	  num_oldcolors = -1;
 static Boolean	  usenet;
+static Boolean	  usemcut;
 static int	  npixels;
 
+static void	set_direct_pixels(void);
+static void	free_pic_pixmaps(F_compound *obj, struct _pics *pics);
+static Boolean	remap_later_work(XtPointer client_data);
+static Boolean	remap_later_pending = False;
+
 #define REMAP_MSG	"Remapping picture colors..."
 #define REMAP_MSG2	"Remapping picture colors...Done"
 
+/*
+ * Remap the picture colors once the current redraw is done, then draw
+ * all the pictures again with the new pixels.  Used when a picture read
+ * while drawing turns out to have new colors.
+ */
+
+void remap_imagecolors_later(void)
+{
+    if (remap_later_pending)
+	return;
+    remap_later_pending = True;
+    (void) XtAppAddWorkProc(tool_app, remap_later_work, (XtPointer) NULL);
+}
+
+static Boolean
+remap_later_work(XtPointer client_data)
+{
+    remap_later_pending = False;
+    remap_imagecolors();
+    /* the pixmaps of all pictures may hold old pixel values */
+    free_pixmaps(&objects);
+    redraw_images(&objects);
+    return True;		/* done, remove the work proc */
+}
+
 /* remap the colors for all the pictures in the picture repository */
 
 void remap_imagecolors(void)
@@ -228,6 +262,12 @@ void remap_imagecolors(void)
     if (tool_cells <= 2 || appres.monochrome)
 	return;
 
+    /* on TrueColor/DirectColor we can compute the pixel of any color */
+    if (DIRECT_PIXELS) {
+	set_direct_pixels();
+	return;
+    }
+
     npixels = 0;
 
     /* first see if there are enough colorcells for all image colors */
@@ -288,40 +328,54 @@ void remap_imagecolors(void)
 	if (check_cancel())
 	    return;
 
-	/* count total number of pixels in all the pictures */
-	npixels = count_pixels();
+	usemcut = (strcasecmp(appres.quantizer, "mediancut") == 0 && mcut_init() == 0);
+	if (usemcut) {
+	    /* median cut needs only the colors of each picture and their counts */
+	    set_temp_cursor(wait_cursor);
+	    /* stop if the user pressed the cancel button while counting */
+	    if (!add_all_colors()) {
+		reset_cursor();
+		return;
+	    }
 
-	/* check if user pressed cancel button */
-	if (check_cancel())
-	    return;
+	    /* make a new colortable with the optimal colors */
+	    avail_image_cols = mcut_clrtab(avail_image_cols);
+	} else {
+	    /* count total number of pixels in all the pictures */
+	    npixels = count_pixels();
 
-	/* initialize the neural network */
-	/* -1 means can't alloc memory, -2 or more means must have that many times
-		as many pixels */
-	set_temp_cursor(wait_cursor);
-	if ((stat=neu_init(npixels)) <= -2) {
-	    mult = -stat;
-	    npixels *= mult;
-	    /* try again with more pixels */
-	    stat = neu_init2(npixels);
-	}
-	if (stat == -1) {
-	    /* couldn't alloc memory for network */
-	    fprintf(stderr,"Can't alloc memory for neural network\n");
-	    reset_cursor();
-	    put_msg(REMAP_MSG2);
-	    app_flush();
-	    return;
-	}
-	/* now add all pixels to the samples */
-	for (i=0; i<mult; i++)
-	    add_all_pixels();
+	    /* check if user pressed cancel button */
+	    if (check_cancel())
+		return;
 
-	/* make a new colortable with the optimal colors */
-	avail_image_cols = neu_clrtab(avail_image_cols);
+	    /* initialize the neural network */
+	    /* -1 means can't alloc memory, -2 or more means must have that many times
+		    as many pixels */
+	    set_temp_cursor(wait_cursor);
+	    if ((stat=neu_init(npixels)) <= -2) {
+		mult = -stat;
+		npixels *= mult;
+		/* try again with more pixels */
+		stat = neu_init2(npixels);
+	    }
+	    if (stat == -1) {
+		/* couldn't alloc memory for network */
+		fprintf(stderr,"Can't alloc memory for neural network\n");
+		reset_cursor();
+		put_msg(REMAP_MSG2);
+		app_flush();
+		return;
+	    }
+	    /* now add all pixels to the samples */
+	    for (i=0; i<mult; i++)
+		add_all_pixels();
+
+	    /* make a new colortable with the optimal colors */
+	    avail_image_cols = neu_clrtab(avail_image_cols);
+	}
 
 	/* now change the color cells with the new colors */
-	/* clrtab[][] is the colormap produced by neu_clrtab */
+	/* clrtab[][] is the colormap produced by neu_clrtab or mcut_clrtab */
 	for (i=0; i<avail_image_cols; i++) {
 	    image_cells[i].red   = (unsigned short) clrtab[i][N_RED] << 8;
 	    image_cells[i].green = (unsigned short) clrtab[i][N_GRN] << 8;
@@ -358,6 +412,33 @@ void remap_imagecolors(void)
     app_flush();
 }
 
+/*
+ * Compute the X pixel values of the picture colormaps from the visual's
+ * masks.  Nothing is allocated and no color is shared between pictures,
+ * so only the pictures whose bitmap is new need any work.
+ */
+
+static void
+set_direct_pixels(void)
+{
+    struct _pics   *pics;
+    struct Cmap	   *c;
+    int		    i;
+
+    if (!pixtabs_made)
+	make_pixtabs();
+    for (pics = pictures; pics; pics = pics->next)
+	if (PIC_PRESENT(pics) && pics->numcols > 0 && pics->pixels_gen != pics->bitmap_gen) {
+	    for (i=0; i<pics->numcols; i++) {
+		c = &pics->cmap[i];
+		c->pixel = RGB_PIXEL(c->red & 255, c->green & 255, c->blue & 255);
+	    }
+	    pics->pixels_gen = pics->bitmap_gen;
+	    /* make any pixmaps of this picture again */
+	    free_pic_pixmaps(&objects, pics);
+	}
+}
+
 /* allocate the color cells for the pictures */
 
 void alloc_imagecolors(int num)
@@ -385,7 +466,7 @@ count_colors(void)
 
     ncolors = 0;
     for (pics = pictures; pics; pics = pics->next)
-	if (pics->bitmap != NULL)
+	if (PIC_PRESENT(pics))
 		ncolors += pics->numcols;
     return ncolors;
 }
@@ -410,7 +491,7 @@ void readjust_cmap(void)
 
     /* first adjust the colormaps in the repository */
     for (pics = pictures; pics; pics = pics->next)
-	if (pics->bitmap != NULL && pics->numcols > 0) {
+	if (PIC_PRESENT(pics) && pics->numcols > 0) {
 	    for (i=0; i<pics->numcols; i++) {
 		j = pics->cmap[i].pixel;
 		pics->cmap[i].pixel = image_cells[j].pixel;
@@ -446,6 +527,26 @@ void free_pixmaps(F_compound *obj)
     }
 }
 
+/* free the pixmaps of the picture objects that use picture "pics" */
+
+static void
+free_pic_pixmaps(F_compound *obj, struct _pics *pics)
+{
+    F_line	   *l;
+    F_compound	   *c;
+
+    for (c = obj->compounds; c != NULL; c = c->next)
+	free_pic_pixmaps(c, pics);
+    for (l = obj->lines; l != NULL; l = l->next)
+	if (l->type == T_PICTURE && l->pic->pic_cache == pics && l->pic->pixmap != 0) {
+	    XFreePixmap(tool_d, l->pic->pixmap);
+	    l->pic->pixmap = 0;
+	    if (l->pic->mask != 0)
+		XFreePixmap(tool_d, l->pic->mask);
+	    l->pic->mask = 0;
+	}
+}
+
 void extract_cmap(void)
 {
     struct _pics   *pics;
@@ -453,7 +554,7 @@ void extract_cmap(void)
 
     /* extract the colormaps in the repository */
     for (pics = pictures; pics; pics = pics->next)
-	if (pics->bitmap != NULL && pics->numcols > 0) {
+	if (PIC_PRESENT(pics) && pics->numcols > 0) {
 	    for (i=0; i<pics->numcols; i++) {
 		image_cells[scol].red   = pics->cmap[i].red << 8;
 		image_cells[scol].green = pics->cmap[i].green << 8;
@@ -490,6 +591,64 @@ void add_all_pixels(void)
 	}
 }
 
+/*
+ * Add the colors of all the pictures to the median-cut histogram, each
+ * weighted by the number of pixels using it.  The counts are kept with
+ * the picture, so only pictures that are new or were re-read are scanned.
+ * Returns False if the user cancelled.
+ */
+
+Boolean add_all_colors(void)
+{
+    struct _pics   *pics;
+    BYTE	   col[3];
+    int		   i;
+
+    for (pics = pictures; pics; pics = pics->next)
+	if (PIC_PRESENT(pics) && pics->numcols > 0) {
+	    if (pics->colhist_gen != pics->bitmap_gen) {
+		/* an evicted picture that was never counted can't be counted now */
+		if (pics->bitmap == NULL)
+		    continue;
+		count_pic_colors(pics);
+		/* check if user pressed cancel button */
+		if (pics->colhist_gen != pics->bitmap_gen)
+		    return False;
+	    }
+	    for (i=0; i<pics->numcols; i++) {
+		if (pics->colhist[i] == 0)
+		    continue;
+		col[N_RED] = pics->cmap[i].red;
+		col[N_GRN] = pics->cmap[i].green;
+		col[N_BLU] = pics->cmap[i].blue;
+		mcut_add(col, pics->colhist[i]);
+	    }
+	}
+    return True;
+}
+
+/* count how many pixels of the picture use each of its colors */
+
+void
+count_pic_colors(struct _pics *pics)
+{
+    unsigned char  *bits;
+    int		   i, npix;
+
+    for (i=0; i<MAX_COLORMAP_SIZE; i++)
+	pics->colhist[i] = 0;
+    pics->colhist_gen = 0;
+    bits = (unsigned char *) pics->bitmap;
+    npix = pics->bit_size.x * pics->bit_size.y;
+    for (i=0; i < npix; i++) {
+	/* check if user pressed cancel button */
+	if ((i & 0xffff) == 0 && check_cancel())
+	    return;
+	pics->colhist[bits[i]]++;
+    }
+    pics->colhist_gen = pics->bitmap_gen;
+}
+
 void remap_image_colormap(void)
 {
     struct _pics   *pics;
@@ -498,14 +657,14 @@ void remap_image_colormap(void)
     int		   p;
 
     for (pics = pictures; pics; pics = pics->next)
-	if (pics->bitmap != NULL && pics->numcols > 0) {
+	if (PIC_PRESENT(pics) && pics->numcols > 0) {
 	    for (i=0; i<pics->numcols; i++) {
 		/* real color from the image */
 		col[N_RED] = pics->cmap[i].red;
 		col[N_GRN] = pics->cmap[i].green;
 		col[N_BLU] = pics->cmap[i].blue;
 		/* X color index from the mapping */
-		p = neu_map_pixel(col);
+		p = usemcut? mcut_map_pixel(col): neu_map_pixel(col);
 		pics->cmap[i].pixel = image_cells[p].pixel;
 	    }
 	}
@@ -1119,7 +1278,8 @@ strerror(e)
 #endif /* HAVE_STRERROR */
 
 
-/* for images with no palette, we'll use neural net to reduce to 256 colors with palette */
+/* for images with no palette, we'll use neural net (or median cut) to reduce to 256 colors with palette */
+/* On TrueColor/DirectColor displays the 3-byte pixels are kept as they are */
 
 Boolean
 map_to_palette(F_pic *pic)
@@ -1132,6 +1292,32 @@ map_to_palette(F_pic *pic)
 	w = pic->pic_cache->bit_size.x;
 	h = pic->pic_cache->bit_size.y;
 
+	if (DIRECT_PIXELS && tool_cells > 2 && !appres.monochrome) {
+	    pic->pic_cache->rgb = True;
+	    pic->pic_cache->numcols = 0;
+	    return True;
+	}
+
+	if (strcasecmp(appres.quantizer, "mediancut") == 0 && mcut_init() == 0) {
+	    /* histogram all pixels and make the colortable by median cut */
+	    mcut_add_pixels((unsigned char *) pic->pic_cache->bitmap, (long) w*h);
+	    pic->pic_cache->numcols = mcut_clrtab(256);
+	    for (x=0; x<pic->pic_cache->numcols; x++) {
+		pic->pic_cache->cmap[x].red   = (unsigned short) clrtab[x][N_RED];
+		pic->pic_cache->cmap[x].green = (unsigned short) clrtab[x][N_GRN];
+		pic->pic_cache->cmap[x].blue  = (unsigned short) clrtab[x][N_BLU];
+	    }
+	    old = (unsigned char *) pic->pic_cache->bitmap;
+	    if ((pic->pic_cache->bitmap=malloc(w*(h+2)))==NULL) {
+		free(old);
+		return False;
+	    }
+	    /* map the 3-byte pixels to 1-byte colortable indices */
+	    mcut_map_pixels(old, (unsigned char *) pic->pic_cache->bitmap, (long) w*h);
+	    free(old);
+	    return True;
+	}
+
 	mult = 1;
 	if ((neu_stat=neu_init(w*h)) <= -2) {
 	    mult = -neu_stat;
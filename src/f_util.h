@@ -40,5 +40,7 @@ extern int emptyname_msg (char *name, char *msg);
 extern int get_directory (char *direct);
 extern int ok_to_write (char *file_name, char *op_name);
 extern void remap_imagecolors (void);
+extern void remap_imagecolors_later (void);
+extern void count_pic_colors (struct _pics *pics);
 extern void update_recent_files (void);
 extern void update_xfigrc (char *name, char *string);
@@ -28,6 +28,7 @@
 #include "u_error.h"
 #include "u_fonts.h"
 #include "u_redraw.h"
+#include "u_timing.h"
 #include "u_undo.h"
 #include "w_canvas.h"
 #include "w_indpanel.h"
@@ -263,6 +264,8 @@ static XtResource application_resources[] = {
       XtOffset(appresPtr, transparent), XtRImmediate, (caddr_t) TRANSP_NONE },
     {"library_dir", "Directory", XtRString, sizeof(char *),
       XtOffset(appresPtr, library_dir), XtRString, (caddr_t) OBJLIBDIR},
+    {"library_cache_dir", "Directory", XtRString, sizeof(char *),
+      XtOffset(appresPtr, library_cache_dir), XtRString, (caddr_t) DEF_LIBRARY_CACHE_DIR},
     {"debug", "Debug",   XtRBoolean, sizeof(Boolean),
       XtOffset(appresPtr, DEBUG), XtRBoolean, (caddr_t) & false},
     {"showlengths", "Debug",   XtRBoolean, sizeof(Boolean),
@@ -315,6 +318,24 @@ static XtResource application_resources[] = {
       XtOffset(appresPtr, autorefresh), XtRBoolean, (caddr_t) & false},
     {"write_bak", "Refresh",   XtRBoolean, sizeof(Boolean),
       XtOffset(appresPtr, write_bak), XtRBoolean, (caddr_t) & true},
+    {"smooth_pictures", "Smooth",   XtRBoolean, sizeof(Boolean),
+      XtOffset(appresPtr, smooth_pictures), XtRBoolean, (caddr_t) & false},
+    {"pic_level_budget", "Memory",   XtRInt, sizeof(int),
+      XtOffset(appresPtr, pic_level_budget), XtRImmediate, (caddr_t) DEF_PIC_LEVEL_BUDGET},
+    {"pic_memory_budget", "Memory",   XtRInt, sizeof(int),
+      XtOffset(appresPtr, pic_memory_budget), XtRImmediate, (caddr_t) DEF_PIC_MEMORY_BUDGET},
+    {"quantizer", "Quantizer",   XtRString, sizeof(char *),
+      XtOffset(appresPtr, quantizer), XtRString, (caddr_t) "neural"},
+    {"xft_text", "XftText",   XtRBoolean, sizeof(Boolean),
+      XtOffset(appresPtr, xft_text), XtRBoolean, (caddr_t) & true},
+    {"rottext_cache", "Memory",   XtRInt, sizeof(int),
+      XtOffset(appresPtr, rottext_cache), XtRImmediate, (caddr_t) DEF_ROTTEXT_CACHE},
+    {"timing", "Timing", XtRBoolean, sizeof(Boolean),
+      XtOffset(appresPtr, timing), XtRBoolean, (caddr_t) & false},
+    {"timing_file", "File", XtRString, sizeof(char *),
+      XtOffset(appresPtr, timing_file), XtRString, (caddr_t) NULL},
+    {"timing_edits", "Timing", XtRBoolean, sizeof(Boolean),
+      XtOffset(appresPtr, timing_edits), XtRBoolean, (caddr_t) & false},
 
 #ifdef I18N
     {"international", "International", XtRBoolean, sizeof(Boolean),
@@ -398,6 +419,7 @@ XrmOptionDescRec options[] =
     {"-landscape", ".landscape", XrmoptionNoArg, "True"},
     {"-latexfonts", ".latexfonts", XrmoptionNoArg, "True"},
     {"-left", ".justify", XrmoptionNoArg, "False"},
+    {"-library_cache_dir", ".library_cache_dir", XrmoptionSepArg, 0},
     {"-library_dir", ".library_dir", XrmoptionSepArg, 0},
     {"-library_icon_size", ".library_icon_size", XrmoptionSepArg, 0},
     {"-list_view", ".icon_view", XrmoptionNoArg, "False"},
@@ -412,15 +434,20 @@ XrmOptionDescRec options[] =
     {"-nosplash", ".splash", XrmoptionNoArg, "False"},
     {"-notrack", ".trackCursor", XrmoptionNoArg, "False"},
     {"-nowrite_bak", ".write_bak", XrmoptionNoArg, "False"},
+    {"-noxft_text", ".xft_text", XrmoptionNoArg, "False"},
     {"-overlap", ".overlap", XrmoptionNoArg, "True"},
     {"-pageborder", ".pageborder", XrmoptionSepArg, (caddr_t) NULL},
     {"-paper_size", ".paper_size", XrmoptionSepArg, (caddr_t) NULL},
     {"-pheight", ".pheight", XrmoptionSepArg, 0},
+    {"-pic_level_budget", ".pic_level_budget", XrmoptionSepArg, 0},
+    {"-pic_memory_budget", ".pic_memory_budget", XrmoptionSepArg, 0},
     {"-Portrait", ".landscape", XrmoptionNoArg, "False"},
     {"-portrait", ".landscape", XrmoptionNoArg, "False"},
     {"-pwidth", ".pwidth", XrmoptionSepArg, 0},
+    {"-quantizer", ".quantizer", XrmoptionSepArg, 0},
     {"-right", ".justify", XrmoptionNoArg, "True"},
     {"-rigidtext", ".rigidtext", XrmoptionNoArg, "True"},
+    {"-rottext_cache", ".rottext_cache", XrmoptionSepArg, 0},
     {"-rulerthick", ".rulerthick", XrmoptionSepArg, 0},
     {"-scalablefonts", ".scalablefonts", XrmoptionNoArg, "True"},
     {"-scale_factor", ".scale_factor", XrmoptionSepArg, 0},
@@ -433,6 +460,7 @@ XrmOptionDescRec options[] =
     {"-showaxislines", ".showaxislines", XrmoptionNoArg, "True"},
     {"-single", ".multiple", XrmoptionNoArg, "False"},
     {"-smooth_factor", ".smooth_factor", XrmoptionSepArg, 0},
+    {"-smooth_pictures", ".smooth_pictures", XrmoptionNoArg, "True"},
     {"-smallicons", ".smallicons", XrmoptionNoArg, "True"},
     {"-specialtext", ".specialtext", XrmoptionNoArg, "True"},
     {"-spellcheckcommand", ".spellcheckcommand", XrmoptionSepArg, 0},
@@ -454,11 +482,15 @@ XrmOptionDescRec options[] =
     {"-startpsFont", ".startpsFont", XrmoptionSepArg, 0},
     {"-starttextstep", ".starttextstep",  XrmoptionSepArg, 0},
     {"-tablet", ".tablet", XrmoptionNoArg, "True"},
+    {"-timing", ".timing", XrmoptionNoArg, "True"},
+    {"-timing_file", ".timing_file", XrmoptionSepArg, 0},
+    {"-timing_edits", ".timing_edits", XrmoptionNoArg, "True"},
     {"-track", ".trackCursor", XrmoptionNoArg, "True"},
     {"-transparent_color", ".transparent", XrmoptionSepArg, 0},
     {"-userscale", ".userscale", XrmoptionSepArg, 0},
     {"-write_v40", ".write_v40", XrmoptionNoArg, "True"},
     {"-write_bak", ".write_bak", XrmoptionNoArg, "True"},
+    {"-xft_text", ".xft_text", XrmoptionNoArg, "True"},
     {"-userunit", ".userunit", XrmoptionSepArg, 0},
     {"-axislines", ".axislines", XrmoptionSepArg, "pink"},
     {"-zoom", ".zoom", XrmoptionSepArg, 0},
@@ -514,6 +546,7 @@ char *help_list[] = {
 	"[-landscape] ",
 	"[-latexfonts] ",
 	"[-left] ",
+	"[-library_cache_dir <directory>] ",
 	"[-library_dir <directory>] ",
 	"[-library_icon_size <size>] ",
 	"[-list_view] ",
@@ -527,14 +560,19 @@ char *help_list[] = {
 	"[-nosplash] ",
 	"[-notrack] ",
 	"[-nowrite_bak] ",
+	"[-noxft_text] ",
 	"[-overlap] ",
 	"[-pageborder <color>] ",
 	"[-paper_size <size>] ",
 	"[-pheight <height>] ",
+	"[-pic_level_budget <kbytes>] ",
+	"[-pic_memory_budget <kbytes>] ",
 	"[-portrait] ",
 	"[-pwidth <width>] ",
+	"[-quantizer <method>] ",
 	"[-right] ",
 	"[-rigidtext] ",
+	"[-rottext_cache <kbytes>] ",
 	"[-rulerthick <width>] ",
 	"[-scale_factor <factor>] ",
 	"[-scalablefonts] ",
@@ -548,6 +586,7 @@ char *help_list[] = {
 	"[-single] ",
 	"[-smallicons] ",
 	"[-smooth_factor <factor>] ",
+	"[-smooth_pictures] ",
 	"[-specialtext] ",
 	"[-spellcheckcommand <command>] ",
 	"[-spinner_delay <delay>] ",
@@ -563,6 +602,9 @@ char *help_list[] = {
 	"[-startpsFont <font>] ",
 	"[-starttextstep <number>] ",
 	"[-tablet] ",
+	"[-timing] ",
+	"[-timing_file <file>] ",
+	"[-timing_edits] ",
 	"[-track] ",
 	"[-transparent_color <color number>] ",
 	"[-update file1 file2 ...] ",
@@ -570,6 +612,7 @@ char *help_list[] = {
 	"[-userunit <units>] ",
 	"[-visual <visual>] ",
 	"[-write_bak] ",
+	"[-xft_text] ",
 	"[-zoom <zoom scale>] ",
 #ifdef I18N
 	"[-international] ",
@@ -648,6 +691,8 @@ void main(int argc, char **argv)
     char	    tmpstr[PATH_MAX];
 
 
+    timing_phase(NULL);
+
     export_up = False;
     geomspec = False;
 
@@ -838,6 +883,8 @@ void main(int argc, char **argv)
 
     read_xfigrc();
 
+    timing_phase("toolkit and resources");
+
     /**************************************************************/
     /* All option args have now been deleted, leaving other args. */
     /**************************************************************/
@@ -863,6 +910,7 @@ void main(int argc, char **argv)
 		setup_icons_small();
 	else
 		setup_icons_big();
+	timing_phase("icons");
 
 #ifdef I18N
     /************************************************************/
@@ -928,9 +976,13 @@ void main(int argc, char **argv)
     /* copy initial appres settings to current variables */
     init_settings();
 
+    timing_phase("colors and settings");
+
     /* initialize font information */
     init_font();
 
+    timing_phase("fonts");
+
     /* initialize the active_layers array */
     reset_layers();
     /* and the depth counters */
@@ -1106,10 +1158,14 @@ void main(int argc, char **argv)
      * in existence
      */
 
+    timing_phase("creating widgets");
+
     XtManageChildren(children, NCHILDREN);
     XtRealizeWidget(tool);
     tool_w = XtWindow(tool);
 
+    timing_phase("realizing widgets");
+
     /* get the current directory so we can go back here on abort */
     get_directory(orig_dir);
 
@@ -1203,6 +1259,8 @@ void main(int argc, char **argv)
 
     init_gc();
 
+    timing_phase("GCs and fill patterns");
+
     /* now that widgets have been realized, do some final setups */
 
     setup_main_menus();
@@ -1248,6 +1306,18 @@ void main(int argc, char **argv)
 	sprintf(tmpstr, "%s/%s", cur_file_dir, appres.library_dir);
 	appres.library_dir = strdup(tmpstr);
     }
+    /* userhome falls back to "." without HOME; don't put the cache there */
+    if (appres.library_cache_dir[0] == '~') {
+	char	*home = getenv("HOME");
+
+	if (home != NULL && *home != '\0') {
+	    sprintf(tmpstr, "%s%s", home, &appres.library_cache_dir[1]);
+	    appres.library_cache_dir = strdup(tmpstr);
+	} else {
+	    /* no home directory, don't keep library index files */
+	    appres.library_cache_dir = "";
+	}
+    }
 
     /********************************************/
     /* save any filename passed in cur_filename */
@@ -1322,6 +1392,8 @@ void main(int argc, char **argv)
     /* let things settle down */
     process_pending();
 
+    timing_phase("setting up panels");
+
     /* now that everything is up, check the version number in the app-defaults */
     sprintf(version,"%s", PACKAGE_VERSION);
     if (!appres.version || strcasecmp(appres.version,version) < 0) {
@@ -1342,8 +1414,10 @@ void main(int argc, char **argv)
     /*  do the splash screen now */
     /*****************************/
 
-    if (appres.splash)
+    if (appres.splash) {
 	splash_screen();
+	timing_phase("splash screen");
+    }
 
     /************************************************/
     /* if the user passed a filename to us, load it */
@@ -1358,6 +1432,9 @@ void main(int argc, char **argv)
     /* reset the cursor */
     reset_cursor();
 
+    timing_edits();
+    timing_report();
+
     /* add a timeout proc to check if the fig file has changed to redisplay it */
     /* this is only done if the user has requested -autorefresh */
     if (appres.autorefresh) {
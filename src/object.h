@@ -106,6 +106,16 @@ typedef struct f_pos {
 }
 	F_pos;
 
+/* one level of the reduced-size copies of a picture bitmap (see f_picobj.c) */
+struct _piclevel {
+		char	     *bitmap;		/* same format as _pics bitmap, NULL if evicted */
+		F_pos	      bit_size;		/* size of this level in pixels */
+		long	      bytes;		/* memory used by bitmap */
+		unsigned long last_use;		/* for evicting the least recently used */
+	     };
+
+#define MAX_PIC_LEVELS	16
+
 struct _pics {
 		char	     *file;
 		char	     *realname;		/* in case the actual file is compressed (.gz, etc) */
@@ -116,12 +126,25 @@ struct _pics {
 	        F_pos	      bit_size;		/* size of bitmap in pixels */
 	        struct Cmap   cmap[MAX_COLORMAP_SIZE];  /* for GIF/XPM/JPEG files */
 	        int	      numcols;		/* number of colors in cmap */
+		Boolean	      rgb;		/* bitmap has 3 bytes (blue, green, red) per pixel */
 	        int	      transp;		/* transparent color (TRANSP_NONE if none) for GIFs */
 		int	      refcount;		/* number of references to picture */
+		struct _piclevel levels[MAX_PIC_LEVELS]; /* levels[k] is bitmap reduced by 2^k */
+		int	      nlevels;		/* number of levels made (0 = none) */
+		char	     *levels_of;	/* bitmap the levels were made from */
+		unsigned long colhist[MAX_COLORMAP_SIZE]; /* number of pixels of each color */
+		unsigned long bitmap_gen;	/* changes when a different image is read */
+		unsigned long colhist_gen;	/* bitmap_gen the counts were made for */
+		unsigned long pixels_gen;	/* bitmap_gen the cmap pixels were computed for */
+		Boolean	      evicted;		/* bitmap freed to save memory, read again when needed */
+		unsigned long last_drawn;	/* when the picture was last drawn */
 		struct _pics *prev;
 		struct _pics *next;
 	     };
 
+/* picture has an image, even if its bitmap has been evicted */
+#define PIC_PRESENT(p)	((p)->bitmap != NULL || (p)->evicted)
+
 /*******************/
 /* point structure */
 /*******************/
@@ -316,6 +339,29 @@ typedef struct f_line {
 /* Text object */
 /***************/
 
+/*
+ * Where a text is drawn, worked out by draw_text() and kept until something
+ * it depends on changes.  The positions are relative to base_x, base_y so
+ * moving the text does not change them.
+ */
+
+typedef struct f_text_layout {
+    Boolean	    valid;
+    Boolean	    just_valid;	/* dx, dy are set */
+    float	    zoom;	/* what the layout was made for */
+    XFontStruct	   *fontstruct;
+    float	    angle;
+    int		    type, flags, size;
+    int		    ascent, length, descent;
+    Boolean	    xft;	/* justified by the width drawn with Xft */
+
+    int		    xmin, ymin, xmax, ymax;	/* bounds, as from text_bound() */
+    int		    x1,y1, x2,y2, x3,y3, x4,y4;	/* corners of the text box */
+    int		    dx, dy;	/* where the string starts after justification */
+    Boolean	    greek;	/* too small to draw, drawn as a gray line */
+}
+	F_text_layout;
+
 typedef struct f_text {
     int		    tagged;
     int		    distrib;
@@ -340,6 +386,7 @@ typedef struct f_text {
     int		    ascent;	/* Fig units */
     int		    length;	/* Fig units */
     int		    descent;	/* from XTextExtents(), not in file */
+    F_text_layout   layout;	/* not in file */
     int		    base_x;
     int		    base_y;
     int		    pen_style;
@@ -378,6 +425,10 @@ typedef struct f_text {
 #define		text_length(t) \
 			(hidden_text(t) ? hidden_text_length : t->length)
 
+/* the string changed without a change of font or size */
+#define		text_changed(t) \
+			((t)->layout.valid = False)
+
 #define		using_ps	(cur_textflags & PSFONT_TEXT)
 
 /* SEE NOTE AT TOP BEFORE CHANGING ANYTHING IN THE f_spline STRUCTURE */
@@ -473,6 +524,16 @@ typedef struct f_compound {
     struct f_compound *compounds;
     struct f_compound *next;
   char extra;			/* operation specific data */
+    /* the last object of each list and the head of the list it was found
+       for, only kept for "objects" (see u_list.c) */
+    struct f_last {
+	struct f_line     *lines, *lines_head;
+	struct f_ellipse  *ellipses, *ellipses_head;
+	struct f_spline   *splines, *splines_head;
+	struct f_text     *texts, *texts_head;
+	struct f_arc      *arcs, *arcs_head;
+	struct f_compound *compounds, *compounds_head;
+    }		       last;
 }
 	F_compound;
 
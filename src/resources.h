@@ -87,6 +87,17 @@
 
 #define	Color		int
 
+/* default memory (kbytes) for the reduced copies of pictures, see f_picobj.c */
+#define DEF_PIC_LEVEL_BUDGET 32768
+/* default memory (kbytes) for the full picture bitmaps */
+#define DEF_PIC_MEMORY_BUDGET 524288
+/* default memory (kbytes) for the cache of rotated text bitmaps, see w_rottext.c */
+#ifdef CACHE_SIZE_LIMIT
+#define DEF_ROTTEXT_CACHE CACHE_SIZE_LIMIT
+#else
+#define DEF_ROTTEXT_CACHE 20000
+#endif
+
 /* default number of colors to use for GIF/XPM */
 /* this can be overridden in resources or command-line arg */
 #define DEF_MAX_IMAGE_COLS 64
@@ -204,6 +215,7 @@ typedef struct _appres {
     Boolean	 landscape;
     Boolean	 latexfonts;
     char	*library_dir;		/* for object library path */
+    char	*library_cache_dir;	/* for the library index files */
     float	 magnification;		/* export/print magnification */
     int		 max_image_colors;	/* max colors to use for GIF/XPM images */
     Boolean	 monochrome;
@@ -274,6 +286,15 @@ typedef struct _appres {
     Boolean	 crosshair;		/* draw crosshair cursor wherever the pointer is */
     Boolean	 autorefresh;		/* automatically redraw figure when file has changed */
     Boolean	 write_bak;		/* automatically rename current to .bak when saving */
+    Boolean	 smooth_pictures;	/* interpolate when scaling pictures on the canvas */
+    int		 pic_level_budget;	/* memory (kbytes) for reduced copies of pictures */
+    int		 pic_memory_budget;	/* memory (kbytes) for picture bitmaps */
+    char	*quantizer;		/* color reduction for pictures: neural or mediancut */
+    Boolean	 xft_text;		/* draw canvas text anti-aliased with Xft */
+    int		 rottext_cache;		/* memory (kbytes) for rotated text bitmaps */
+    Boolean	 timing;		/* print the time taken by starting up */
+    char	*timing_file;		/* or append it to this file */
+    Boolean	 timing_edits;		/* and time some editing of the figure */
 
 #ifdef I18N
     Boolean	 international;
@@ -203,8 +203,8 @@ void active_compound_bound(F_compound *compound, int *xmin, int *ymin, int *xmax
 	}
     }
 
+    /* nested compounds keep their own corners up to date */
     for (c = compound->compounds; c != NULL; c = c->next) {
-	active_compound_bound(c, &sx, &sy, &bx, &by, active_only);
 	sx = c->nwcorner.x;
 	sy = c->nwcorner.y;
 	bx = c->secorner.x;
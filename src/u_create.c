@@ -482,7 +482,15 @@ create_picture_entry(void)
     picture->bitmap = (unsigned char *) NULL;
     picture->transp = TRANSP_NONE;
     picture->numcols = 0;
+    picture->rgb = False;
     picture->refcount = 0;
+    picture->nlevels = 0;
+    picture->levels_of = NULL;
+    picture->bitmap_gen = 0;
+    picture->colhist_gen = 0;
+    picture->pixels_gen = 0;
+    picture->evicted = False;
+    picture->last_drawn = 0;
     picture->prev = picture->next = NULL;
     if (appres.DEBUG)
 	fprintf(stderr,"create picture entry %x\n",(intptr_t) picture);
@@ -653,6 +661,7 @@ create_text(void)
     }
     t->tagged = 0;
     t->fontstruct = 0;
+    t->layout.valid = False;
     t->comments = NULL;
     t->cstring = NULL;
     t->next = NULL;
@@ -727,6 +736,7 @@ create_compound(void)
     c->parent = NULL;
     c->GABPtr = NULL;
     c->next = NULL;
+    clear_last_objects(c);
     #ifdef SLIDES_SUPPORT
     c->slides = NULL;
     #endif
@@ -45,6 +45,43 @@ static void array_place_spline(int x, int y),   place_spline(int x, int y),   pl
 static void array_place_ellipse(int x, int y),  place_ellipse(int x, int y),  place_ellipse_x(int x, int y),  cancel_ellipse(void);
 static void array_place_text(int x, int y),     place_text(int x, int y),     place_text_x(int x, int y),     cancel_text(void);
 static void array_place_compound(int x, int y), place_compound(int x, int y), place_compound_x(int x, int y), cancel_drag_compound(void);
+static void batch_ellipse(int x, int y);
+static void batch_arc(int x, int y);
+static void batch_line(int x, int y);
+static void batch_text(int x, int y);
+static void batch_spline(int x, int y);
+static void batch_compound(int x, int y);
+
+/*
+ * Array placement puts the first copy in the figure as usual, and collects
+ * the rest in "batch".  Then add_batch() appends them to the figure in one
+ * go, counting their depths once and redrawing the area they cover once.
+ */
+
+static F_compound	batch, batch_tails;
+
+static void
+start_batch(void)
+{
+    bzero((char *) &batch, COMOBJ_SIZE);
+    bzero((char *) &batch_tails, COMOBJ_SIZE);
+}
+
+static void
+add_batch(void)
+{
+    F_compound	    tails;
+    int		    xmin, ymin, xmax, ymax;
+
+    if (batch.arcs == NULL && batch.compounds == NULL &&
+	batch.ellipses == NULL && batch.lines == NULL &&
+	batch.splines == NULL && batch.texts == NULL)
+	    return;
+    compound_bound(&batch, &xmin, &ymin, &xmax, &ymax);
+    tail(&objects, &tails);
+    append_objects(&objects, &batch, &tails);
+    redisplay_zoomed_region(xmin, ymin, xmax, ymax);
+}
 
 /***************************** ellipse section ************************/
 
@@ -127,14 +164,19 @@ array_place_ellipse(int x, int y)
 	    ny = cur_numycopies;
 	    if (ny == 0)
 		ny++;
+	    start_batch();
 	    for (i = 0, x = start_x;  i < nx; i++, x+=delta_x) {
 		for (j = 0, y = start_y;  j < ny; j++, y+=delta_y) {
 		    if (i || j ) {
-			place_ellipse_x(x, y);
+			if (i + j == 1 && (i == 0 || ny == 1))
+			    place_ellipse_x(x, y);	/* the first one */
+			else
+			    batch_ellipse(x, y);
 			new_e = copy_ellipse(cur_e);
 		    }
 		}
 	    }
+	    add_batch();
 	}
     }
     /* put all new ellipses in the saved objects structure for undo */
@@ -153,6 +195,19 @@ place_ellipse(int x, int y)
     place_ellipse_x(x, y);
 }
 
+static void
+batch_ellipse(int x, int y)
+{
+    adjust_pos(x, y, fix_x, fix_y, &x, &y);
+    translate_ellipse(new_e, x - fix_x, y - fix_y);
+    new_e->next = NULL;
+    if (batch_tails.ellipses)
+	batch_tails.ellipses->next = new_e;
+    else
+	batch.ellipses = new_e;
+    batch_tails.ellipses = new_e;
+}
+
 static void
 place_ellipse_x(int x, int y)
 {
@@ -254,14 +309,19 @@ array_place_arc(int x, int y)
 	    ny = cur_numycopies;
 	    if (ny == 0)
 		ny++;
+	    start_batch();
 	    for (i = 0, x = start_x;  i < nx; i++, x+=delta_x) {
 		for (j = 0, y = start_y;  j < ny; j++, y+=delta_y) {
 		    if (i || j ) {
-			place_arc_x(x, y);
+			if (i + j == 1 && (i == 0 || ny == 1))
+			    place_arc_x(x, y);	/* the first one */
+			else
+			    batch_arc(x, y);
 			new_a = copy_arc(cur_a);
 		    }
 		}
 	    }
+	    add_batch();
 	}
     }
     /* put all new arcs in the saved objects structure for undo */
@@ -280,6 +340,19 @@ place_arc(int x, int y)
     place_arc_x(x, y);
 }
 
+static void
+batch_arc(int x, int y)
+{
+    adjust_pos(x, y, fix_x, fix_y, &x, &y);
+    translate_arc(new_a, x - fix_x, y - fix_y);
+    new_a->next = NULL;
+    if (batch_tails.arcs)
+	batch_tails.arcs->next = new_a;
+    else
+	batch.arcs = new_a;
+    batch_tails.arcs = new_a;
+}
+
 static void
 place_arc_x(int x, int y)
 {
@@ -316,6 +389,7 @@ init_linedragging(F_line *l, int x, int y)
     int		    xmin, ymin, xmax, ymax;
 
     new_l = l;
+    reset_elastic_outline();
     cur_x = fix_x = x;
     cur_y = fix_y = y;
     canvas_locmove_proc = moving_line;
@@ -328,14 +402,14 @@ init_linedragging(F_line *l, int x, int y)
 	line_bound(l, &xmin, &ymin, &xmax, &ymax);
 	get_links(xmin, ymin, xmax, ymax);
     }
-    elastic_moveline(new_l->points);
+    elastic_movenewline();
 }
 
 static void
 cancel_line(void)
 {
     canvas_ref_proc = canvas_locmove_proc = null_proc;
-    elastic_moveline(new_l->points);
+    elastic_movenewline();
     /* erase last lengths if appres.showlengths is true */
     erase_lengths();
     free_linkinfo(&cur_links);
@@ -358,7 +432,7 @@ array_place_line(int x, int y)
     int		    nx, ny;
     F_line	   *save_line;
 
-    elastic_moveline(new_l->points);
+    elastic_movenewline();
     /* erase last lengths if appres.showlengths is true */
     erase_lengths();
     tail(&objects, &object_tails);
@@ -386,14 +460,19 @@ array_place_line(int x, int y)
 	    ny = cur_numycopies;
 	    if (ny == 0)
 		ny++;
+	    start_batch();
 	    for (i = 0, x = start_x;  i < nx; i++, x+=delta_x) {
 		for (j = 0, y = start_y;  j < ny; j++, y+=delta_y) {
 		    if (i || j ) {
-			place_line_x(x, y);
+			if (i + j == 1 && (i == 0 || ny == 1))
+			    place_line_x(x, y);	/* the first one */
+			else
+			    batch_line(x, y);
 			new_l = copy_line(cur_l);
 		    }
 		}
 	    }
+	    add_batch();
 	}
     }
     /* put all new lines in the saved objects structure for undo */
@@ -406,12 +485,25 @@ array_place_line(int x, int y)
 static void
 place_line(int x, int y)
 {
-    elastic_moveline(new_l->points);
+    elastic_movenewline();
     /* erase last lengths if appres.showlengths is true */
     erase_lengths();
     place_line_x(x, y);
 }
 
+static void
+batch_line(int x, int y)
+{
+    adjust_pos(x, y, fix_x, fix_y, &x, &y);
+    translate_line(new_l, x - fix_x, y - fix_y);
+    new_l->next = NULL;
+    if (batch_tails.lines)
+	batch_tails.lines->next = new_l;
+    else
+	batch.lines = new_l;
+    batch_tails.lines = new_l;
+}
+
 static void
 place_line_x(int x, int y)
 {
@@ -527,14 +619,19 @@ array_place_text(int x, int y)
 	    ny = cur_numycopies;
 	    if (ny == 0)
 		ny++;
+	    start_batch();
 	    for (i = 0, x = start_x;  i < nx; i++, x+=delta_x) {
 		for (j = 0, y = start_y;  j < ny; j++, y+=delta_y) {
 		    if (i || j ) {
-			place_text_x(x, y);
+			if (i + j == 1 && (i == 0 || ny == 1))
+			    place_text_x(x, y);	/* the first one */
+			else
+			    batch_text(x, y);
 			new_t = copy_text(cur_t);
 		    }
 		}
 	    }
+	    add_batch();
 	}
     }
     /* put all new texts in the saved objects structure for undo */
@@ -572,6 +669,19 @@ place_text(int x, int y)
     place_text_x(x, y);
 }
 
+static void
+batch_text(int x, int y)
+{
+    adjust_pos(x, y, fix_x, fix_y, &x, &y);
+    translate_text(new_t, x - fix_x, y - fix_y);
+    new_t->next = NULL;
+    if (batch_tails.texts)
+	batch_tails.texts->next = new_t;
+    else
+	batch.texts = new_t;
+    batch_tails.texts = new_t;
+}
+
 static void
 place_text_x(int x, int y)
 {
@@ -606,6 +716,7 @@ void
 init_splinedragging(F_spline *s, int x, int y)
 {
     new_s = s;
+    reset_elastic_outline();
     cur_x = fix_x = x;
     cur_y = fix_y = y;
     canvas_locmove_proc = moving_spline;
@@ -614,14 +725,14 @@ init_splinedragging(F_spline *s, int x, int y)
     canvas_middlebut_proc = array_place_spline;
     canvas_rightbut_proc = cancel_spline;
     set_action_on();
-    elastic_moveline(new_s->points);
+    elastic_movenewspline();
 }
 
 static void
 cancel_spline(void)
 {
     canvas_ref_proc = canvas_locmove_proc = null_proc;
-    elastic_moveline(new_s->points);
+    elastic_movenewspline();
     /* erase last lengths if appres.showlengths is true */
     erase_lengths();
     if (return_proc == copy_selected) {
@@ -643,7 +754,7 @@ array_place_spline(int x, int y)
     int		    nx, ny;
     F_spline	   *save_spline;
 
-    elastic_moveline(new_s->points);
+    elastic_movenewspline();
     /* erase last lengths if appres.showlengths is true */
     erase_lengths();
 
@@ -673,14 +784,19 @@ array_place_spline(int x, int y)
 	    ny = cur_numycopies;
 	    if (ny == 0)
 		ny++;
+	    start_batch();
 	    for (i = 0, x = start_x;  i < nx; i++, x+=delta_x) {
 		for (j = 0, y = start_y;  j < ny; j++, y+=delta_y) {
 		    if (i || j ) {
-			place_spline_x(x, y);
+			if (i + j == 1 && (i == 0 || ny == 1))
+			    place_spline_x(x, y);	/* the first one */
+			else
+			    batch_spline(x, y);
 			new_s = copy_spline(cur_s);
 		    }
 		}
 	    }
+	    add_batch();
 	}
     }
     /* put all new splines in the saved objects structure for undo */
@@ -693,12 +809,25 @@ array_place_spline(int x, int y)
 static void
 place_spline(int x, int y)
 {
-    elastic_moveline(new_s->points);
+    elastic_movenewspline();
     /* erase last lengths if appres.showlengths is true */
     erase_lengths();
     place_spline_x(x, y);
 }
 
+static void
+batch_spline(int x, int y)
+{
+    adjust_pos(x, y, fix_x, fix_y, &x, &y);
+    translate_spline(new_s, x - fix_x, y - fix_y);
+    new_s->next = NULL;
+    if (batch_tails.splines)
+	batch_tails.splines->next = new_s;
+    else
+	batch.splines = new_s;
+    batch_tails.splines = new_s;
+}
+
 static void
 place_spline_x(int x, int y)
 {
@@ -806,14 +935,19 @@ array_place_compound(int x, int y)
 	    ny = cur_numycopies;
 	    if (ny == 0)
 		ny++;
+	    start_batch();
 	    for (i = 0, x = start_x;  i < nx; i++, x+=delta_x) {
 		for (j = 0, y = start_y;  j < ny; j++, y+=delta_y) {
 		    if (i || j ) {
-			place_compound_x(x, y);
+			if (i + j == 1 && (i == 0 || ny == 1))
+			    place_compound_x(x, y);	/* the first one */
+			else
+			    batch_compound(x, y);
 			new_c = copy_compound(cur_c);
 		    }
 		}
 	    }
+	    add_batch();
 	}
     }
     /* put all new compounds in the saved objects structure for undo */
@@ -833,6 +967,19 @@ place_compound(int x, int y)
     place_compound_x(x, y);
 }
 
+static void
+batch_compound(int x, int y)
+{
+    adjust_pos(x, y, fix_x, fix_y, &x, &y);
+    translate_compound(new_c, x - fix_x, y - fix_y);
+    new_c->next = NULL;
+    if (batch_tails.compounds)
+	batch_tails.compounds->next = new_c;
+    else
+	batch.compounds = new_c;
+    batch_tails.compounds = new_c;
+}
+
 static void
 place_compound_x(int x, int y)
 {
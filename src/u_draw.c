@@ -24,6 +24,7 @@
 #include "object.h"
 #include "paintop.h"
 #include "d_text.h"
+#include "f_picobj.h"
 #include "f_util.h"
 #include "u_bound.h"
 #include "u_create.h"
@@ -36,6 +37,7 @@
 #include "w_drawprim.h"
 #include "w_file.h"
 #include "w_indpanel.h"
+#include "w_color.h"
 #include "w_layers.h"
 #include "w_msgpanel.h"
 #include "w_setup.h"
@@ -43,6 +45,7 @@
 #include "w_zoom.h"
 #include "u_redraw.h"
 #include "w_cursor.h"
+#include "w_xfttext.h"
 #include <X11/ImUtil.h>	/* _XInitImageFuncPtrs() */
 
 static Boolean add_point(int x, int y);
@@ -606,11 +609,11 @@ void draw_line(F_line *line, int op)
     /* is it a picture object or a Fig figure? */
     if (line->type == T_PICTURE) {
 	if (line->pic->pic_cache) {
-	    if ((line->pic->pic_cache->bitmap != NULL) && active_layer(line->depth) IF_SLIDES(&& active_object_slides (line, O_POLYLINE))) {
+	    if (PIC_PRESENT(line->pic->pic_cache) && active_layer(line->depth) IF_SLIDES(&& active_object_slides (line, O_POLYLINE))) {
 		/* only draw the picture if there is a pixmap AND this layer is active */
 		draw_pic_pixmap(line, op);
 		return;
-	    } else if (line->pic->pic_cache->bitmap != NULL) {
+	    } else if (PIC_PRESENT(line->pic->pic_cache)) {
 		/* if there is a pixmap but the layer is not active, draw it as a filled box */
 		line->type = T_BOX;
 		line->fill_style = NUMSHADEPATS-1;	 /* fill it */
@@ -809,6 +812,9 @@ void draw_pic_pixmap(F_line *box, int op)
 	abs(box->pic->pix_height - height) > 1 ||
 	box->pic->pix_flipped != box->pic->flipped)
 	    create_pic_pixmap(box, rotation, width, height, box->pic->flipped);
+    if (box->pic->pixmap == 0)
+	return;
+    pic_drawn(box->pic->pic_cache);
 
     if (box->pic->mask) {
       /* mask is in rectangle (xmin,ymin)...(xmax,ymax)
@@ -866,23 +872,240 @@ void draw_pic_pixmap(F_line *box, int op)
  * and columns. This routine re-samples the input bitmap creating
  * an output bitmap of dimensions width-by-height. This output
  * bitmap is made into a Pixmap for display purposes.
+ *
+ * The re-sampling is done through two index tables, one for the output
+ * columns and one for the output rows, which already contain the rotation
+ * and flipping of the picture.  The source offset of output pixel (i,j)
+ * is then simply rowtab[j] + coltab[i], so there is no division and no
+ * separate rotate/flip pass.  Each output row only depends on its own
+ * table entries, so rows are scaled independently of each other.
  */
 
 #define	ALLOC_PIC_ERR "Can't alloc memory for image: %s"
 
+/* number of output rows between checks of the cancel button */
+#define PIC_CANCEL_ROWS	64
+
+/* fixed-point fraction bits for the bilinear (smooth) resampler */
+#define PIC_FRAC_BITS	8
+#define PIC_FRAC_ONE	(1 << PIC_FRAC_BITS)
+
+/*
+ * Fill tab[0..n-1] with the source index (times stride) for n output
+ * positions taken from a source of csize pixels.  If reverse is set the
+ * table runs backwards (horizontal or vertical swap of the output).
+ */
+
+static void
+pic_index_table(int *tab, int n, int csize, int stride, Boolean reverse)
+{
+    int		    k, m;
+
+    for (k = 0; k < n; k++) {
+	m = reverse ? n - 1 - k : k;
+	tab[k] = (int) ((long) csize * m / n) * stride;
+    }
+}
+
+/*
+ * Same as pic_index_table() but for bilinear sampling: each entry gets the
+ * two neighbouring source indices (times stride) and the fixed-point weight
+ * of the second one.  Sample positions are pixel centers.
+ */
+
+static void
+pic_smooth_table(int *tab0, int *tab1, int *frac, int n, int csize, int stride,
+		 Boolean reverse)
+{
+    int		    k, m, idx;
+    long	    pos;
+
+    for (k = 0; k < n; k++) {
+	m = reverse ? n - 1 - k : k;
+	/* center of output pixel m in source pixels, in fixed point */
+	pos = (((long) (2 * m + 1) * csize) << PIC_FRAC_BITS) / (2 * n)
+			- PIC_FRAC_ONE / 2;
+	if (pos < 0)
+	    pos = 0;
+	idx = pos >> PIC_FRAC_BITS;
+	if (idx >= csize - 1) {
+	    idx = csize - 1;
+	    frac[k] = 0;
+	} else {
+	    frac[k] = pos & (PIC_FRAC_ONE - 1);
+	}
+	tab0[k] = idx * stride;
+	tab1[k] = (idx < csize - 1 ? idx + 1 : idx) * stride;
+    }
+}
+
+/*
+ * Make the lookup table from colormap index to the bytes of the X pixel
+ * value for the image format we use (always LSBFirst, see create_pic_pixmap).
+ * The table entries are built byte by byte so that a plain store of
+ * lut32[] or lut16[] puts them in memory in LSBFirst order on any machine.
+ */
+
+static void
+pic_pixel_lut(struct Cmap *cmap, int numcols, unsigned int *lut32,
+	      unsigned short *lut16, unsigned char *lut8)
+{
+    unsigned char   b[4];
+    unsigned long   pixel;
+    int		    i;
+
+    for (i = 0; i < 256; i++) {
+	pixel = i < numcols ? cmap[i].pixel : 0;
+	b[0] = (unsigned char) pixel;
+	b[1] = (unsigned char) (pixel >> 8);
+	b[2] = (unsigned char) (pixel >> 16);
+	b[3] = (unsigned char) (pixel >> 24);
+	memcpy(&lut32[i], b, 4);
+	memcpy(&lut16[i], b, 2);
+	memcpy(&lut8[3*i], b, 3);
+    }
+}
+
+/* scale one row of a colormapped picture using the nearest-neighbour tables */
+
+static void
+pic_scale_row(unsigned char *dst, unsigned char *src, int *coltab, int width,
+	      unsigned int *lut32, unsigned short *lut16, unsigned char *lut8)
+{
+    unsigned char  *p;
+    int		    i;
+
+    switch (image_bpp) {
+      case 4:
+	for (i = 0; i < width; i++)
+	    ((unsigned int *) dst)[i] = lut32[src[coltab[i]]];
+	break;
+      case 3:
+	for (i = 0; i < width; i++, dst += 3) {
+	    p = &lut8[3 * src[coltab[i]]];
+	    dst[0] = p[0];
+	    dst[1] = p[1];
+	    dst[2] = p[2];
+	}
+	break;
+      case 2:
+	for (i = 0; i < width; i++)
+	    ((unsigned short *) dst)[i] = lut16[src[coltab[i]]];
+	break;
+      default:
+	for (i = 0; i < width; i++)
+	    dst[i] = lut8[3 * src[coltab[i]]];
+	break;
+    }
+}
+
+/* store an X pixel value at dst in LSBFirst order (see create_pic_pixmap) */
+
+static void
+pic_put_pixel(unsigned char *dst, unsigned long pixel)
+{
+    switch (image_bpp) {
+      case 4: dst[3] = (unsigned char) (pixel >> 24);
+      /* fall through */
+      case 3: dst[2] = (unsigned char) (pixel >> 16);
+      /* fall through */
+      case 2: dst[1] = (unsigned char) (pixel >> 8);
+      /* fall through */
+      default: dst[0] = (unsigned char) pixel;
+    }
+}
+
+/*
+ * Scale one row of a packed RGB picture (3 bytes per pixel, blue first)
+ * using the nearest-neighbour tables.  Only used when DIRECT_PIXELS.
+ */
+
+static void
+pic_rgb_row(unsigned char *dst, unsigned char *src, int *coltab, int width)
+{
+    unsigned char  *p;
+    int		    i;
+
+    for (i = 0; i < width; i++, dst += image_bpp) {
+	p = src + coltab[i];
+	pic_put_pixel(dst, RGB_PIXEL(p[2], p[1], p[0]));
+    }
+}
+
+/*
+ * Scale one row of a colormapped picture with bilinear interpolation of
+ * the colormap RGB values.  Only used for TrueColor and DirectColor visuals,
+ * where any RGB value can be turned into a pixel value directly.
+ * rowp0/rowp1 are the two source rows (already offset), rowfrac the weight
+ * of rowp1.
+ */
+
+static void
+pic_smooth_row(unsigned char *dst, unsigned char *rowp0, unsigned char *rowp1,
+	       int rowfrac, int *col0, int *col1, int *colfrac, int width,
+	       struct Cmap *cmap)
+{
+    struct Cmap	   *c00, *c01, *c10, *c11;
+    int		    i, fx, fy, r, g, b;
+
+    fy = rowfrac;
+    for (i = 0; i < width; i++, dst += image_bpp) {
+	fx = colfrac[i];
+	c00 = &cmap[rowp0[col0[i]]];
+	c01 = &cmap[rowp0[col1[i]]];
+	c10 = &cmap[rowp1[col0[i]]];
+	c11 = &cmap[rowp1[col1[i]]];
+#define LERP2(ch) \
+	((((c00->ch * (PIC_FRAC_ONE - fx) + c01->ch * fx) * (PIC_FRAC_ONE - fy)) + \
+	  ((c10->ch * (PIC_FRAC_ONE - fx) + c11->ch * fx) * fy)) >> (2 * PIC_FRAC_BITS))
+	r = LERP2(red);
+	g = LERP2(green);
+	b = LERP2(blue);
+#undef LERP2
+	pic_put_pixel(dst, RGB_PIXEL(r & 255, g & 255, b & 255));
+    }
+}
+
+/* the same for a packed RGB picture, where the tables are in units of bytes */
+
+static void
+pic_smooth_rgb_row(unsigned char *dst, unsigned char *rowp0, unsigned char *rowp1,
+	       int rowfrac, int *col0, int *col1, int *colfrac, int width)
+{
+    unsigned char  *c00, *c01, *c10, *c11;
+    int		    i, fx, fy, r, g, b;
+
+    fy = rowfrac;
+    for (i = 0; i < width; i++, dst += image_bpp) {
+	fx = colfrac[i];
+	c00 = rowp0 + col0[i];
+	c01 = rowp0 + col1[i];
+	c10 = rowp1 + col0[i];
+	c11 = rowp1 + col1[i];
+#define LERP2(ch) \
+	((((c00[ch] * (PIC_FRAC_ONE - fx) + c01[ch] * fx) * (PIC_FRAC_ONE - fy)) + \
+	  ((c10[ch] * (PIC_FRAC_ONE - fx) + c11[ch] * fx) * fy)) >> (2 * PIC_FRAC_BITS))
+	b = LERP2(0);
+	g = LERP2(1);
+	r = LERP2(2);
+#undef LERP2
+	pic_put_pixel(dst, RGB_PIXEL(r & 255, g & 255, b & 255));
+    }
+}
+
 void create_pic_pixmap(F_line *box, int rotation, int width, int height, int flipped)
 {
     int		    cwidth, cheight;
-    int		    i,j,k;
+    int		    i,j;
     int		    bwidth;
-    unsigned char  *data, *tdata, *mask;
+    unsigned char  *data, *mask, *bitmap;
     int		    nbytes;
     int		    bbytes;
-    int		    ibit, jbit, jnb;
-    int		    wbit;
     int		    fg, bg;
+    int		   *coltab, *rowtab;
+    F_pos	    csize;
     XImage	   *image;
-    Boolean	    type1,hswap,vswap;
+    Boolean	    transpose, hswap, vswap;
 
     /* this could take a while */
     set_temp_cursor(wait_cursor);
@@ -894,9 +1117,6 @@ void create_pic_pixmap(F_line *box, int rotation, int width, int height, int fli
     if (appres.DEBUG)
 	fprintf(stderr,"Scaling pic pixmap to %dx%d pixels\n",width,height);
 
-    cwidth = box->pic->pic_cache->bit_size.x;	/* current width, height */
-    cheight = box->pic->pic_cache->bit_size.y;
-
     box->pic->color = box->pen_color;
     box->pic->pix_rotation = rotation;
     box->pic->pix_width = width;
@@ -907,73 +1127,82 @@ void create_pic_pixmap(F_line *box, int rotation, int width, int height, int fli
 
     mask = (unsigned char *) 0;
 
-    /* create a new bitmap at the specified size (requires interpolation) */
+    /* the bitmap may have been freed to save memory; read it again */
+    if (!load_pic_bitmap(box->pic->pic_cache)) {
+	reset_cursor();
+	return;
+    }
+
+    /*
+     * Work out how the output maps onto the source.  Output pixel (i,j)
+     * comes from source column i and row j, or, if the picture is turned
+     * by 90 or 270 degrees (or flipped at 0/180), from source column j and
+     * row i.  The horizontal and vertical swaps reverse the i and j order.
+     */
+    transpose = !((!flipped && (rotation == 0 || rotation == 180)) ||
+		  (flipped && !(rotation == 0 || rotation == 180)));
+    hswap = (rotation == 180 || rotation == 270);
+    vswap = (rotation == 90 || rotation == 180);
+
+    /* scale from the smallest reduced copy of the bitmap that is large enough */
+    if (transpose)
+	bitmap = (unsigned char *) pic_level_bitmap(box->pic->pic_cache,
+					height, width, &csize);
+    else
+	bitmap = (unsigned char *) pic_level_bitmap(box->pic->pic_cache,
+					width, height, &csize);
+    cwidth = csize.x;				/* current width, height */
+    cheight = csize.y;
+
+    coltab = (int *) malloc(width * sizeof(int));
+    rowtab = (int *) malloc(height * sizeof(int));
+    if (coltab == NULL || rowtab == NULL) {
+	file_msg(ALLOC_PIC_ERR, box->pic->pic_cache->file);
+	free(coltab);
+	free(rowtab);
+	reset_cursor();
+	return;
+    }
 
     /* MONOCHROME display OR XBM */
-    if (box->pic->pic_cache->numcols == 0) {
+    if (box->pic->pic_cache->numcols == 0 && !box->pic->pic_cache->rgb) {
+	    unsigned char  *src, *dst, bitmask;
+	    int		    sbyte;
+
 	    nbytes = (width + 7) / 8;
 	    bbytes = (cwidth + 7) / 8;
-	    if ((data = (unsigned char *) malloc(nbytes * height)) == NULL) {
-		file_msg(ALLOC_PIC_ERR, box->pic->pic_cache->file);
-		return;
-	    }
-	    if ((tdata = (unsigned char *) malloc(nbytes)) == NULL) {
+	    if ((data = (unsigned char *) calloc(nbytes, height)) == NULL) {
 		file_msg(ALLOC_PIC_ERR, box->pic->pic_cache->file);
-		free(data);
+		free(coltab);
+		free(rowtab);
+		reset_cursor();
 		return;
 	    }
-	    bzero((char*)data, nbytes * height);	/* clear memory */
-	    if ((!flipped && (rotation == 0 || rotation == 180)) ||
-		(flipped && !(rotation == 0 || rotation == 180))) {
-		for (j = 0; j < height; j++) {
-		    /* check if user pressed cancel button */
-		    if (check_cancel())
-			break;
-		    jbit = cheight * j / height * bbytes;
-		    for (i = 0; i < width; i++) {
-			ibit = cwidth * i / width;
-			wbit = (unsigned char) *(box->pic->pic_cache->bitmap + jbit + ibit / 8);
-			if (wbit & (1 << (7 - (ibit & 7))))
-			    *(data + j * nbytes + i / 8) += (1 << (i & 7));
-		    }
-		}
+	    /* in the monochrome case, the column table holds the bit number */
+	    if (!transpose) {
+		pic_index_table(coltab, width, cwidth, 1, hswap);
+		pic_index_table(rowtab, height, cheight, bbytes, vswap);
 	    } else {
-		for (j = 0; j < height; j++) {
-		    /* check if user pressed cancel button */
-		    if (check_cancel())
-			break;
-		    ibit = cwidth * j / height;
-		    for (i = 0; i < width; i++) {
-			jbit = cheight * i / width * bbytes;
-			wbit = (unsigned char) *(box->pic->pic_cache->bitmap + jbit + ibit / 8);
-			if (wbit & (1 << (7 - (ibit & 7))))
-			    *(data + (height - j - 1) * nbytes + i / 8) += (1 << (i & 7));
-		    }
-		}
+		pic_index_table(coltab, width, cheight, bbytes, hswap);
+		pic_index_table(rowtab, height, cwidth, 1, vswap);
 	    }
-
-	    /* horizontal swap */
-	    if (rotation == 180 || rotation == 270)
-		for (j = 0; j < height; j++) {
-		    /* check if user pressed cancel button */
-		    if (check_cancel())
-			break;
-		    jnb = j*nbytes;
-		    bzero((char*)tdata, nbytes);
+	    for (j = 0; j < height; j++) {
+		/* check if user pressed cancel button */
+		if (j % PIC_CANCEL_ROWS == 0 && check_cancel())
+		    break;
+		dst = data + j * nbytes;
+		if (!transpose) {
+		    src = bitmap + rowtab[j];
 		    for (i = 0; i < width; i++)
-			if (*(data + jnb + (width - i - 1) / 8) & (1 << ((width - i - 1) & 7)))
-			    *(tdata + i / 8) += (1 << (i & 7));
-		    bcopy(tdata, data + j * nbytes, nbytes);
-		}
-
-	    /* vertical swap */
-	    if ((!flipped && (rotation == 180 || rotation == 270)) ||
-		(flipped && !(rotation == 180 || rotation == 270))) {
-		for (j = 0; j < (height + 1) / 2; j++) {
-		    jnb = j*nbytes;
-		    bcopy(data + jnb, tdata, nbytes);
-		    bcopy(data + (height - j - 1) * nbytes, data + jnb, nbytes);
-		    bcopy(tdata, data + (height - j - 1) * nbytes, nbytes);
+			if (src[coltab[i] >> 3] & (0x80 >> (coltab[i] & 7)))
+			    dst[i >> 3] |= (1 << (i & 7));
+		} else {
+		    /* the source column is fixed for this output row */
+		    sbyte = rowtab[j] >> 3;
+		    bitmask = 0x80 >> (rowtab[j] & 7);
+		    for (i = 0; i < width; i++)
+			if (bitmap[coltab[i] + sbyte] & bitmask)
+			    dst[i >> 3] |= (1 << (i & 7));
 		}
 	    }
 
@@ -991,188 +1220,125 @@ void create_pic_pixmap(F_line *box, int rotation, int width, int height, int fli
 	    box->pic->pixmap = XCreatePixmapFromBitmapData(tool_d, canvas_win,
 					(char *)data, width, height, fg,bg, tool_dpth);
 	    free(data);
-	    free(tdata);
 
       /* EPS, PCX, XPM, GIF, PNG or JPEG on *COLOR* display */
-      /* It is important to note that the Cmap pixels are unsigned long. */
-      /* Therefore all manipulation of the image data should be as unsigned long. */
+      /* The image data is always written LSBFirst (the byte order of the
+	 XImage is set to match below), so it doesn't matter what endian
+	 machine this is. */
       /* bpl = bytes per line */
+      /* A packed RGB picture (only made when DIRECT_PIXELS) has 3 bytes per
+	 pixel, and its pixel values are computed from the RGB values. */
 
       } else {
-	    unsigned char	*pixel, *cpixel, *dst, *src, tmp;
-	    int			 bpl, cbpp, cbpl;
-	    unsigned int	*Lpixel;
-	    unsigned short	*Spixel;
-	    unsigned char	*Cpixel;
-	    struct Cmap		*cmap = box->pic->pic_cache->cmap;
-	    Boolean		 endian;
-	    unsigned char	 byte;
-
-	    /* figure what endian machine this is (big=True or little=False) */
-	    endian = True;
-	    bpl = 1;
-	    Cpixel = (char *) &bpl;
-	    /* look at first byte of integer */
-	    if (Cpixel[0] == 1)
-		endian = False;
-
-	    cbpp = 1;
-	    cbpl = cwidth * cbpp;
+	    unsigned char   *dst;
+	    int		     bpl, transp, ps;
+	    Boolean	     rgb = box->pic->pic_cache->rgb;
+	    struct Cmap	    *cmap = box->pic->pic_cache->cmap;
+	    unsigned int     lut32[256];
+	    unsigned short   lut16[256];
+	    unsigned char    lut8[3*256];
+	    Boolean	     smooth;
+
 	    bpl = width * image_bpp;
 	    if ((data = (unsigned char *) malloc(bpl * height)) == NULL) {
 		file_msg(ALLOC_PIC_ERR,box->pic->pic_cache->file);
+		free(coltab);
+		free(rowtab);
+		reset_cursor();
 		return;
 	    }
+	    transp = box->pic->pic_cache->transp;
 	    /* allocate mask for any transparency information */
-	    if (box->pic->pic_cache->subtype == T_PIC_GIF &&
-	        box->pic->pic_cache->transp != TRANSP_NONE) {
+	    if (box->pic->pic_cache->subtype == T_PIC_GIF && transp != TRANSP_NONE) {
 		    if ((mask = (unsigned char *) malloc((width+7)/8 * height)) == NULL) {
 			file_msg(ALLOC_PIC_ERR,box->pic->pic_cache->file);
 			free(data);
+			free(coltab);
+			free(rowtab);
+			reset_cursor();
 			return;
 		    }
 		    /* set all bits in mask */
-		    for (i = (width+7)/8 * height - 1; i >= 0; i--)
-			*(mask+i)=  (unsigned char) 255;
+		    memset(mask, 255, (width+7)/8 * height);
 	    }
 	    bwidth = (width+7)/8;
-	    bzero((char*)data, bpl * height);
-
-	    type1 = False;
-	    hswap = False;
-	    vswap = False;
-
-	    if ((!flipped && (rotation == 0 || rotation == 180)) ||
-		(flipped && !(rotation == 0 || rotation == 180)))
-			type1 = True;
-	    /* horizontal swap */
-	    if (rotation == 180 || rotation == 270)
-		hswap = True;
-	    /* vertical swap */
-	    if ((!flipped && (rotation == 90 || rotation == 180)) ||
-		( flipped && (rotation == 90 || rotation == 180)))
-			vswap = True;
-
-	    for( j=0; j<height; j++ ) {
-		  /* check if user pressed cancel button */
-		  if (check_cancel())
-			break;
 
-		if (type1) {
-			src = box->pic->pic_cache->bitmap + (j * cheight / height * cbpl);
-			dst = data + (j * bpl);
-		} else {
-			src = box->pic->pic_cache->bitmap + (j * cbpl / height);
-			dst = data + (j * bpl);
-		}
+	    /* interpolate if the user wants it and we can make any color we like */
+	    smooth = appres.smooth_pictures && mask == NULL && DIRECT_PIXELS;
+	    if ((smooth || rgb) && !pixtabs_made)
+		make_pixtabs();
+
+	    /* bytes per source pixel */
+	    ps = rgb ? 3 : 1;
+	    if (!transpose) {
+		pic_index_table(coltab, width, cwidth, ps, hswap);
+		pic_index_table(rowtab, height, cheight, cwidth * ps, vswap);
+	    } else {
+		pic_index_table(coltab, width, cheight, cwidth * ps, hswap);
+		pic_index_table(rowtab, height, cwidth, ps, vswap);
+	    }
+
+	    if (smooth) {
+		int	*col1, *colfrac, *row1, *rowfrac;
 
-		pixel = dst;
-		for( i=0; i<width; i++ ) {
-		    if (type1) {
-			    cpixel = src + (i * cbpl / width );
+		col1 = (int *) malloc(2 * width * sizeof(int));
+		row1 = (int *) malloc(2 * height * sizeof(int));
+		if (col1 == NULL || row1 == NULL) {
+		    /* fall back to nearest neighbour */
+		    free(col1);
+		    free(row1);
+		    smooth = False;
+		} else {
+		    colfrac = col1 + width;
+		    rowfrac = row1 + height;
+		    if (!transpose) {
+			pic_smooth_table(coltab, col1, colfrac, width, cwidth, ps, hswap);
+			pic_smooth_table(rowtab, row1, rowfrac, height, cheight, cwidth * ps, vswap);
 		    } else {
-			    cpixel = src + (i * cheight / width * cbpl);
-		    }
-		    /* if this pixel is the transparent color then clear the mask pixel */
-		    if (box->pic->pic_cache->transp != TRANSP_NONE &&
-			(*cpixel==(unsigned char) box->pic->pic_cache->transp)) {
-			  if (type1) {
-			    if (hswap) {
-				if (vswap)
-				    clr_mask_bit(height-j-1,width-i-1,bwidth,mask);
-				else
-				    clr_mask_bit(j,width-i-1,bwidth,mask);
-			    } else {
-				if (vswap)
-				    clr_mask_bit(height-j-1,i,bwidth,mask);
-				else
-				    clr_mask_bit(j,i,bwidth,mask);
-			    }
-			  } else {
-			    if (!vswap) {
-				if (hswap)
-				    clr_mask_bit(j,width-i-1,bwidth,mask);
-				else
-				    clr_mask_bit(j,i,bwidth,mask);
-			    } else {
-				if (hswap)
-				    clr_mask_bit(height-j-1,width-i-1,bwidth,mask);
-				else
-				    clr_mask_bit(height-j-1,i,bwidth,mask);
-			    }
-			  } /* type */
+			pic_smooth_table(coltab, col1, colfrac, width, cheight, cwidth * ps, hswap);
+			pic_smooth_table(rowtab, row1, rowfrac, height, cwidth, ps, vswap);
 		    }
-		    if (image_bpp == 4) {
-			Lpixel = (unsigned int *) pixel;
-			*Lpixel = (unsigned int) cmap[*cpixel].pixel;
-			/* swap the 4 bytes on big-endian machines */
-			if (endian) {
-			    Cpixel = (char *) Lpixel;
-			    byte = Cpixel[0]; Cpixel[0] = Cpixel[3]; Cpixel[3] = byte;
-			    byte = Cpixel[1]; Cpixel[1] = Cpixel[2]; Cpixel[2] = byte;
-			}
-		    } else if (image_bpp == 3) {
-			unsigned char *p;
-			p = (unsigned char *)&(cmap[*cpixel].pixel);
-			/* note which endian */
-			if (endian) {
-			    Cpixel = (unsigned char *) pixel+2;
-			    *Cpixel-- = *p++;
-			    *Cpixel-- = *p++;
-			    *Cpixel = *p;
-			} else {
-			    Cpixel = (unsigned char *) pixel;
-			    *Cpixel++ = *p++;
-			    *Cpixel++ = *p++;
-			    *Cpixel = *p;
-			}
-		    } else if (image_bpp == 2) {
-			Spixel = (unsigned short *) pixel;
-			*Spixel = (unsigned short)cmap[*cpixel].pixel;
-			/* swap the 2 bytes on big-endian machines */
-			if (endian) {
-			    Cpixel = (char *) Lpixel;
-			    byte = Cpixel[0]; Cpixel[0] = Cpixel[1]; Cpixel[1] = byte;
-			}
-		    } else {
-			Cpixel = (unsigned char *) pixel;
-			*Cpixel = (unsigned char)cmap[*cpixel].pixel;
+		    for (j = 0; j < height; j++) {
+			/* check if user pressed cancel button */
+			if (j % PIC_CANCEL_ROWS == 0 && check_cancel())
+			    break;
+			if (rgb)
+			    pic_smooth_rgb_row(data + j * bpl, bitmap + rowtab[j],
+					bitmap + row1[j], rowfrac[j],
+					coltab, col1, colfrac, width);
+			else
+			    pic_smooth_row(data + j * bpl, bitmap + rowtab[j],
+					bitmap + row1[j], rowfrac[j],
+					coltab, col1, colfrac, width, cmap);
 		    }
-		    /* next pixel position */
-		    pixel += image_bpp;
+		    free(col1);
+		    free(row1);
 		}
 	    }
 
-	    /* horizontal swap */
-	    if (hswap) {
-		for( j=0; j<height; j++ ) {
-		  /* check if user pressed cancel button */
-		  if (check_cancel())
+	    if (!smooth && rgb) {
+		for (j = 0; j < height; j++) {
+		    /* check if user pressed cancel button */
+		    if (j % PIC_CANCEL_ROWS == 0 && check_cancel())
 			break;
-		  dst = data + (j * bpl);
-		  src = dst + ((width - 1) * image_bpp);
-		  for( i=0; i<width/2; i++, src -= 2*image_bpp ) {
-		    for( k=0; k<image_bpp; k++, dst++, src++ ) {
-		      tmp = *dst;
-		      *dst = *src;
-		      *src = tmp;
-		    }
-		  }
+		    pic_rgb_row(data + j * bpl, bitmap + rowtab[j], coltab, width);
 		}
-	    }
-
-	    /* vertical swap */
-	    if (vswap) {
-		for( i=0; i<width; i++ ) {
-		  dst = data + (i * image_bpp);
-		  src = dst + ((height - 1) * bpl);
-		  for( j=0; j<height/2; j++, dst += (width-1)*image_bpp, src -= (width+1)*image_bpp ) {
-		    for( k=0; k<image_bpp; k++, dst++, src++ ) {
-		      tmp = *dst;
-		      *dst = *src;
-		      *src = tmp;
+	    } else if (!smooth) {
+		pic_pixel_lut(cmap, box->pic->pic_cache->numcols, lut32, lut16, lut8);
+		for (j = 0; j < height; j++) {
+		    /* check if user pressed cancel button */
+		    if (j % PIC_CANCEL_ROWS == 0 && check_cancel())
+			break;
+		    dst = data + j * bpl;
+		    pic_scale_row(dst, bitmap + rowtab[j], coltab, width,
+					lut32, lut16, lut8);
+		    /* clear the mask bit of pixels which have the transparent color */
+		    if (mask) {
+			unsigned char *src = bitmap + rowtab[j];
+			for (i = 0; i < width; i++)
+			    if (src[coltab[i]] == (unsigned char) transp)
+				clr_mask_bit(j, i, bwidth, mask);
 		    }
-		  }
 		}
 	    }
 
@@ -1197,6 +1363,8 @@ void create_pic_pixmap(F_line *box, int rotation, int width, int height, int fli
 		free(mask);
 	    }
     }
+    free(coltab);
+    free(rowtab);
     reset_cursor();
 }
 
@@ -1218,23 +1386,89 @@ void clr_mask_bit(int r, int c, int bwidth, unsigned char *mask)
 
 static char    *hidden_text_string = "<<>>";
 
+/*
+ * Make the layout of text valid for the current zoom and its font, angle,
+ * justification and metrics, and return it.
+ */
+
+static F_text_layout *
+text_layout(F_text *text)
+{
+    F_text_layout  *l = &text->layout;
+
+    if (l->valid && l->zoom == text->zoom && l->fontstruct == text->fontstruct &&
+	l->angle == text->angle && l->type == text->type &&
+	l->flags == text->flags && l->size == text->size &&
+	l->ascent == text->ascent && l->length == text->length &&
+	l->descent == text->descent)
+	    return l;
+
+    l->valid = True;
+    l->just_valid = False;
+    l->zoom = text->zoom;
+    l->fontstruct = text->fontstruct;
+    l->angle = text->angle;
+    l->type = text->type;
+    l->flags = text->flags;
+    l->size = text->size;
+    l->ascent = text->ascent;
+    l->length = text->length;
+    l->descent = text->descent;
+
+    text_bound(text, &l->xmin, &l->ymin, &l->xmax, &l->ymax,
+	       &l->x1,&l->y1, &l->x2,&l->y2, &l->x3,&l->y3, &l->x4,&l->y4);
+    l->xmin -= text->base_x;  l->xmax -= text->base_x;
+    l->ymin -= text->base_y;  l->ymax -= text->base_y;
+    l->x1 -= text->base_x;  l->y1 -= text->base_y;
+    l->x2 -= text->base_x;  l->y2 -= text->base_y;
+    l->x3 -= text->base_x;  l->y3 -= text->base_y;
+    l->x4 -= text->base_x;  l->y4 -= text->base_y;
+
+    l->greek = text->size*display_zoomscale < MIN_X_FONT_SIZE;
+    return l;
+}
+
+/*
+ * The size of the string of text in Fig units, at zoom 1.  fstruct is the
+ * unzoomed X font of text, used when the text is not drawn with Xft.
+ */
+
+PR_SIZE
+text_size(F_text *text, XFontStruct *fstruct)
+{
+#ifdef USE_XFT
+    PR_SIZE	    size;
+
+    if (xft_text_size(text, &size))
+	return size;
+#endif /* USE_XFT */
+    return textsize(fstruct, strlen(text->cstring), text->cstring);
+}
+
 void draw_text(F_text *text, int op)
 {
     PR_SIZE	    size;
     int		    x,y;
-    int		    xmin, ymin, xmax, ymax;
     int		    x1,y1, x2,y2, x3,y3, x4,y4;
     double	    cost, sint;
+    F_text_layout  *l;
+    Boolean	    xft = False;
 
     if (text->zoom != zoomscale || text->fontstruct == (XFontStruct*) 0)
 	reload_text_fstruct(text);
-    text_bound(text, &xmin, &ymin, &xmax, &ymax,
-	       &x1,&y1, &x2,&y2, &x3,&y3, &x4,&y4);
+    l = text_layout(text);
 
-    if (!overlapping(ZOOMX(xmin), ZOOMY(ymin), ZOOMX(xmax), ZOOMY(ymax),
+    x = text->base_x;
+    y = text->base_y;
+    if (!overlapping(ZOOMX(x+l->xmin), ZOOMY(y+l->ymin), ZOOMX(x+l->xmax), ZOOMY(y+l->ymax),
 		     clip_xmin, clip_ymin, clip_xmax, clip_ymax))
 	return;
 
+    x1 = x+l->x1;  y1 = y+l->y1;
+    x2 = x+l->x2;  y2 = y+l->y2;
+    x3 = x+l->x3;  y3 = y+l->y3;
+    x4 = x+l->x4;  y4 = y+l->y4;
+
     /* outline the text bounds in red if debug resource is set */
     if (appres.DEBUG) {
 	pw_vector(canvas_win, x1, y1, x2, y2, op, 1, RUBBER_LINE, 0.0, RED);
@@ -1243,34 +1477,54 @@ void draw_text(F_text *text, int op)
 	pw_vector(canvas_win, x4, y4, x1, y1, op, 1, RUBBER_LINE, 0.0, RED);
     }
 
-    x = text->base_x;
-    y = text->base_y;
-    cost = cos(text->angle);
-    sint = sin(text->angle);
-    if (text->type == T_CENTER_JUSTIFIED || text->type == T_RIGHT_JUSTIFIED) {
-	size = textsize(text->fontstruct, strlen(text->cstring),
-			    text->cstring);
-	size.length = size.length/display_zoomscale;
-	if (text->type == T_CENTER_JUSTIFIED) {
-	    x = round(x-cost*size.length/2);
-	    y = round(y+sint*size.length/2);
-	} else {	/* T_RIGHT_JUSTIFIED */
-	    x = round(x-cost*size.length);
-	    y = round(y+sint*size.length);
+#ifdef USE_XFT
+    if (!hidden_text(text) && !l->greek)
+	xft = xft_text_usable(text, op);
+#endif /* USE_XFT */
+
+    if (!l->just_valid || l->xft != xft) {
+	l->dx = l->dy = 0;
+	if (text->type == T_CENTER_JUSTIFIED || text->type == T_RIGHT_JUSTIFIED) {
+#ifdef USE_XFT
+	    if (xft)
+		/* justify by the width of what is drawn */
+		size.length = ZOOM_FACTOR * xft_text_width(text);
+	    else
+#endif /* USE_XFT */
+	    size = textsize(text->fontstruct, strlen(text->cstring),
+				text->cstring);
+	    size.length = size.length/display_zoomscale;
+	    cost = cos(text->angle);
+	    sint = sin(text->angle);
+	    if (text->type == T_CENTER_JUSTIFIED) {
+		l->dx = round(-cost*size.length/2);
+		l->dy = round(sint*size.length/2);
+	    } else {	/* T_RIGHT_JUSTIFIED */
+		l->dx = round(-cost*size.length);
+		l->dy = round(sint*size.length);
+	    }
 	}
+	l->xft = xft;
+	l->just_valid = True;
     }
+    x += l->dx;
+    y += l->dy;
     if (hidden_text(text)) {
 	pw_text(canvas_win, x, y, op, text->depth, lookfont(0,12),
 		text->angle, hidden_text_string, DEFAULT, COLOR_NONE);
     } else {
 	/* if size is less than the displayable size, Greek it by drawing a DARK gray line,
 	   UNLESS the depth is inactive in which case draw it in MED_GRAY */
-	if (text->size*display_zoomscale < MIN_X_FONT_SIZE) {
+	if (l->greek) {
 	    x1 = (x1+x4)/2;
 	    x2 = (x2+x3)/2;
 	    y1 = (y1+y4)/2;
 	    y2 = (y2+y3)/2;
 	    greek_text(text, x1, y1, x2, y2);
+#ifdef USE_XFT
+	} else if (xft) {
+	    xft_draw_text(canvas_win, x, y, op, text);
+#endif /* USE_XFT */
 	} else {
 	    /* Otherwise, draw the text normally */
 	    pw_text(canvas_win, x, y, op, text->depth, text->fontstruct,
@@ -2011,7 +2265,8 @@ void redraw_images(F_compound *obj)
 	redraw_images(c);
     }
     for (l = obj->lines; l != NULL; l = l->next) {
-	if (l->type == T_PICTURE && l->pic->pic_cache && l->pic->pic_cache->numcols > 0)
+	if (l->type == T_PICTURE && l->pic->pic_cache &&
+	    (l->pic->pic_cache->numcols > 0 || l->pic->pic_cache->rgb))
 	    redisplay_line(l);
     }
 }
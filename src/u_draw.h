@@ -53,6 +53,7 @@ extern void draw_arc (F_arc *a, int op);
 extern void draw_ellipse (F_ellipse *e, int op);
 extern void draw_line (F_line *line, int op);
 extern void draw_text (F_text *text, int op);
+extern PR_SIZE text_size (F_text *text, XFontStruct *fstruct);
 extern void redraw_images (F_compound *obj);
 extern void too_many_points (void);
 
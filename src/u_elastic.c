@@ -51,6 +51,24 @@ static void	angle0_line(int x, int y);
 static void	angle45_line(int x, int y);
 static void	angle90_line(int x, int y);
 static void	angle135_line(int x, int y);
+static Boolean	elastic_outline(F_point *pts);
+
+/*
+ * Outline of the line or spline being dragged, in pixels at the current
+ * zoom.  Point 0 is the first point and the others are relative to the
+ * previous one (CoordModePrevious), so moving the outline only changes
+ * point 0 and each motion is a single XDrawLines request.
+ */
+
+static struct {
+    F_point	   *pts;		/* points it was made from */
+    int		    x, y;		/* first point, to notice a moved object */
+    float	    scale;		/* zoom it was made at */
+    int		    xoff, yoff;
+    int		    npts;		/* 0 if the outline can't be used */
+    int		    maxpts;
+    XPoint	   *xpts;
+} outline;
 
 /*************************** BOXES *************************/
 
@@ -324,16 +342,95 @@ elastic_linelink(void)
 void
 moving_line(int x, int y)
 {
-    elastic_moveline(new_l->points);
+    elastic_movenewline();
     adjust_pos(x, y, fix_x, fix_y, &cur_x, &cur_y);
     length_msg(MSG_DIST);
-    elastic_moveline(new_l->points);
+    elastic_movenewline();
 }
 
 void
 elastic_movenewline(void)
 {
-    elastic_moveline(new_l->points);
+    if (!elastic_outline(new_l->points))
+	elastic_moveline(new_l->points);
+}
+
+/* forget the outline of the last dragged object; called when a drag starts */
+
+void
+reset_elastic_outline(void)
+{
+    outline.pts = NULL;
+}
+
+/*
+ * Draw the outline of the dragged points pts at cur_x, cur_y, making it
+ * first if necessary.  Returns False if the caller must draw the points
+ * with elastic_moveline() instead.
+ */
+
+static Boolean
+elastic_outline(F_point *pts)
+{
+    F_point	   *p;
+    XPoint	   *xp;
+    int		    n, x, y, px, py, dx, dy;
+
+    if (pts == NULL || pts->next == NULL)
+	return False;
+    if (pts != outline.pts || pts->x != outline.x || pts->y != outline.y ||
+	zoomscale != outline.scale || zoomxoff != outline.xoff ||
+	zoomyoff != outline.yoff) {
+	    outline.pts = pts;
+	    outline.x = pts->x;
+	    outline.y = pts->y;
+	    outline.scale = zoomscale;
+	    outline.xoff = zoomxoff;
+	    outline.yoff = zoomyoff;
+	    outline.npts = 0;
+	    for (n = 0, p = pts; p != NULL; p = p->next)
+		n++;
+	    /* a request can't be bigger than the server allows */
+	    if (n > XMaxRequestSize(tool_d) - 3)
+		return False;
+	    if (n > outline.maxpts) {
+		if ((xp = (XPoint *) realloc(outline.xpts, n * sizeof(XPoint))) == NULL)
+		    return False;
+		outline.xpts = xp;
+		outline.maxpts = n;
+	    }
+	    px = ZOOMX(pts->x);
+	    py = ZOOMY(pts->y);
+	    n = 1;
+	    for (p = pts->next; p != NULL; p = p->next) {
+		x = ZOOMX(p->x);
+		y = ZOOMY(p->y);
+		/* points that fall on the same pixel add nothing */
+		if (x == px && y == py && p->next != NULL)
+		    continue;
+		dx = x - px;
+		dy = y - py;
+		if (dx < SHRT_MIN || dx > SHRT_MAX || dy < SHRT_MIN || dy > SHRT_MAX)
+		    return False;
+		outline.xpts[n].x = dx;
+		outline.xpts[n].y = dy;
+		n++;
+		px = x;
+		py = y;
+	    }
+	    outline.npts = n;
+    }
+    if (outline.npts == 0)
+	return False;
+
+    outline.xpts[0].x = ZOOMX(pts->x + cur_x - fix_x);
+    outline.xpts[0].y = ZOOMY(pts->y + cur_y - fix_y);
+    set_line_stuff(1, RUBBER_LINE, 0.0, JOIN_MITER, CAP_BUTT,
+		INV_PAINT, DEFAULT);
+    XDrawLines(tool_d, canvas_win, gccache[INV_PAINT], outline.xpts,
+		outline.npts, CoordModePrevious);
+    elastic_links(cur_x - fix_x, cur_y - fix_y, 1.0, 1.0);
+    return True;
 }
 
 void
@@ -889,16 +986,17 @@ elastic_movetext(void)
 void
 moving_spline(int x, int y)
 {
-    elastic_moveline(new_s->points);
+    elastic_movenewspline();
     adjust_pos(x, y, fix_x, fix_y, &cur_x, &cur_y);
     length_msg(MSG_DIST);
-    elastic_moveline(new_s->points);
+    elastic_movenewspline();
 }
 
 void
 elastic_movenewspline(void)
 {
-    elastic_moveline(new_s->points);
+    if (!elastic_outline(new_s->points))
+	elastic_moveline(new_s->points);
 }
 
 /*********** AUXILIARY FUNCTIONS FOR CONSTRAINED MOVES ******************/
@@ -73,6 +73,7 @@ extern void	latex_line(int x, int y);
 extern void	constrainedangle_line(int x, int y);
 extern void	elastic_moveline(F_point *pts);
 extern void	elastic_movenewline(void);
+extern void	reset_elastic_outline(void);
 extern void	elastic_line(void);
 extern void	elastic_dimension_line();
 extern void	moving_line(int x, int y);
@@ -19,6 +19,8 @@
 #include "resources.h"
 #include "object.h"
 #include "u_fonts.h"
+#include "f_picobj.h"
+#include "u_list.h"
 #include "w_drawprim.h"
 
 
@@ -36,6 +38,7 @@ void free_arc(F_arc **list)
 {
     F_arc	   *a, *arc;
 
+    lists_changed();
     for (a = *list; a != NULL;) {
 	arc = a;
 	a = a->next;
@@ -54,6 +57,7 @@ void free_compound(F_compound **list)
 {
     F_compound	   *c, *compound;
 
+    lists_changed();
     for (c = *list; c != NULL;) {
 	compound = c;
 	c = c->next;
@@ -77,6 +81,7 @@ void free_ellipse(F_ellipse **list)
 {
     F_ellipse	   *e, *ellipse;
 
+    lists_changed();
     for (e = *list; e != NULL;) {
 	ellipse = e;
 	e = e->next;
@@ -103,6 +108,7 @@ void free_text(F_text **list)
 {
     F_text	   *t, *text;
 
+    lists_changed();
     for (t = *list; t != NULL;) {
 	text = t;
 	t = t->next;
@@ -128,7 +134,7 @@ void free_spline(F_spline **list)
 
 void free_splinestorage(F_spline *s)
 {
-
+    lists_changed();
     free_points(s->points);
     free_sfactors(s->sfactors);
     if (s->for_arrow)
@@ -142,6 +148,7 @@ void free_splinestorage(F_spline *s)
 
 void free_linestorage(F_line *l)
 {
+    lists_changed();
     free_points(l->points);
     if (l->for_arrow)
 	free((char *) l->for_arrow);
@@ -177,6 +184,7 @@ void free_picture_entry(struct _pics *picture)
 	if (appres.DEBUG)
 	    fprintf(stderr,"Delete picture %p %s, refcount = %d\n",
 				picture, picture->file, picture->refcount);
+	free_pic_levels(picture);
 	if (picture->bitmap)
 	    free((char *) picture->bitmap);
 	free(picture->file);
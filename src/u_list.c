@@ -26,6 +26,7 @@
 #include "u_list.h"
 #include "u_elastic.h"
 #include "u_redraw.h"
+#include "u_snapindex.h"
 #include "u_undo.h"
 #include "w_layers.h"
 #include "w_setup.h"
@@ -36,6 +37,202 @@
 #include "w_slides.h"
 #endif
 
+/*
+ * Deleting an object, and stepping back through a list with prev_*(), need
+ * the object before it.  Rather than walk the list from its head each time,
+ * each type of object has an index: a hash table from the objects of one
+ * list to the objects before them, made by walking the list once.  Deleting
+ * and adding objects keep it right.  Any other change to the list is caught
+ * by checking the link from the object before, or by lists_changed(), which
+ * must be called when objects are taken out of the lists by hand or freed.
+ */
+
+struct pred_index {
+    void	   *head;	/* the list indexed */
+    unsigned long   serial;	/* list_serial when it was made */
+    void	  **objs;	/* the objects, hashed by address */
+    void	  **preds;	/* the object before each, NULL for the head */
+    int		    size;	/* a power of two */
+    int		    count;
+};
+
+static unsigned long	list_serial = 1;
+static struct pred_index arc_preds, compound_preds, ellipse_preds,
+			 line_preds, spline_preds, text_preds;
+
+static void *
+next_arc(void *o)
+{
+    return ((F_arc *) o)->next;
+}
+
+static void *
+next_compound(void *o)
+{
+    return ((F_compound *) o)->next;
+}
+
+static void *
+next_ellipse(void *o)
+{
+    return ((F_ellipse *) o)->next;
+}
+
+static void *
+next_line(void *o)
+{
+    return ((F_line *) o)->next;
+}
+
+static void *
+next_spline(void *o)
+{
+    return ((F_spline *) o)->next;
+}
+
+static void *
+next_text(void *o)
+{
+    return ((F_text *) o)->next;
+}
+
+/* the slot of obj in the table, or the empty one where it would go */
+
+static int
+pred_slot(struct pred_index *pi, void *obj)
+{
+    unsigned long   h;
+    int		    i;
+
+    h = ((unsigned long) obj >> 3) * 2654435761UL;
+    for (i = (int) ((h ^ (h >> 16)) & (pi->size - 1));
+	 pi->objs[i] != NULL && pi->objs[i] != obj; i = (i + 1) & (pi->size - 1))
+	    ;
+    return i;
+}
+
+static void
+pred_set(struct pred_index *pi, void *obj, void *pred)
+{
+    int		    i;
+
+    if (2 * (pi->count + 1) > pi->size) {
+	/* too full, make it again when next needed */
+	pi->serial = 0;
+	return;
+    }
+    i = pred_slot(pi, obj);
+    if (pi->objs[i] == NULL) {
+	pi->objs[i] = obj;
+	pi->count++;
+    }
+    pi->preds[i] = pred;
+}
+
+/* index the list starting at head; False if there is no memory for it */
+
+static Boolean
+pred_build(struct pred_index *pi, void *head, void *(*next)(void *))
+{
+    void	   *csr, *pred, **objs;
+    int		    n, size, i;
+
+    pi->serial = 0;
+    for (n = 0, csr = head; csr != NULL; csr = next(csr))
+	n++;
+    for (size = 256; size < 4 * n; size *= 2)
+	;
+    if (size != pi->size) {
+	if ((objs = (void **) realloc(pi->objs, size * sizeof(void *))) == NULL)
+	    return False;
+	pi->objs = objs;
+	if ((objs = (void **) realloc(pi->preds, size * sizeof(void *))) == NULL)
+	    return False;
+	pi->preds = objs;
+	pi->size = size;
+    }
+    for (i = 0; i < size; i++)
+	pi->objs[i] = NULL;
+    pi->count = 0;
+    for (pred = NULL, csr = head; csr != NULL; pred = csr, csr = next(csr))
+	pred_set(pi, csr, pred);
+    pi->head = head;
+    pi->serial = list_serial;
+    return True;
+}
+
+static Boolean
+pred_lookup(struct pred_index *pi, void *obj, void *(*next)(void *), void **pred)
+{
+    int		    i;
+
+    i = pred_slot(pi, obj);
+    if (pi->objs[i] != obj || pi->preds[i] == NULL || next(pi->preds[i]) != obj)
+	return False;
+    *pred = pi->preds[i];
+    return True;
+}
+
+/*
+ * Find the object before obj in the list starting at head, NULL if obj is
+ * the head.  False if obj isn't in the list.
+ */
+
+static Boolean
+find_pred(struct pred_index *pi, void *head, void *obj, void *(*next)(void *),
+	  void **pred)
+{
+    void	   *csr;
+
+    if (head == NULL || obj == NULL)
+	return False;
+    if (head == obj) {
+	*pred = NULL;
+	return True;
+    }
+    if (pi->serial == list_serial && pi->head == head &&
+	pred_lookup(pi, obj, next, pred))
+	    return True;
+    /* not indexed, or the list has been changed by hand */
+    if (pred_build(pi, head, next))
+	return pred_lookup(pi, obj, next, pred);
+    /* no memory for the index, just walk the list */
+    for (csr = head; csr != NULL && next(csr) != obj; csr = next(csr))
+	;
+    *pred = csr;
+    return csr != NULL;
+}
+
+/* the object after pred (or the head, if pred is NULL) is being taken out */
+
+static void
+pred_unlinked(struct pred_index *pi, void *head, void *pred, void *succ)
+{
+    if (pi->serial != list_serial || pi->head != head)
+	return;
+    if (pred == NULL)
+	pi->head = succ;
+    else if (succ != NULL)
+	pred_set(pi, succ, pred);
+}
+
+/* obj has been added to the list starting at head, after last */
+
+static void
+pred_added(struct pred_index *pi, void *head, void *last, void *obj)
+{
+    if (last != NULL && pi->serial == list_serial && pi->head == head)
+	pred_set(pi, obj, last);
+}
+
+/* objects have been taken out of the lists by hand or freed, forget the indexes */
+
+void
+lists_changed(void)
+{
+    list_serial++;
+}
+
 /*************************************/
 /****** DELETE object from list ******/
 /*************************************/
@@ -44,26 +241,43 @@
 int point_on_perim (F_point *p, int llx, int lly, int urx, int ury);
 int point_on_inside (F_point *p, int llx, int lly, int urx, int ury);
 
+static F_arc	   *objects_last_arc(void);
+static F_compound  *objects_last_compound(void);
+static F_ellipse   *objects_last_ellipse(void);
+static F_line	   *objects_last_line(void);
+static F_spline	   *objects_last_spline(void);
+static F_text	   *objects_last_text(void);
+
 void
 list_delete_arc(F_arc **arc_list, F_arc *arc)
 {
-    F_arc	   *a, *aa;
+    F_arc	   *a;
+    void	   *before;
 
     if (*arc_list == NULL)
 	return;
     if (arc == NULL)
 	return;
 
-    if (arc_list == &objects.arcs)
+    if (arc_list == &objects.arcs) {
 	remove_depth(O_ARC, arc->depth);
-    for (a = aa = *arc_list; aa != NULL; a = aa, aa = aa->next) {
-	if (aa == arc) {
-	    if (aa == *arc_list)
-		*arc_list = (*arc_list)->next;
-	    else
-		a->next = aa->next;
-	    break;
+	snap_index_delete(arc, O_ARC);
+    }
+    if (find_pred(&arc_preds, *arc_list, arc, next_arc, &before)) {
+	a = (F_arc *) before;
+	if (arc_list == &objects.arcs &&
+	    objects.last.arcs_head == *arc_list) {
+		/* keep the last one right, see objects_last_*() */
+		if (objects.last.arcs == arc)
+		    objects.last.arcs = a;
+		if (a == NULL)
+		    objects.last.arcs_head = arc->next;
 	}
+	pred_unlinked(&arc_preds, *arc_list, a, arc->next);
+	if (a == NULL)
+	    *arc_list = arc->next;
+	else
+	    a->next = arc->next;
     }
     arc->next = NULL;
 }
@@ -71,23 +285,33 @@ list_delete_arc(F_arc **arc_list, F_arc *arc)
 void
 list_delete_ellipse(F_ellipse **ellipse_list, F_ellipse *ellipse)
 {
-    F_ellipse	   *q, *r;
+    F_ellipse	   *q;
+    void	   *before;
 
     if (*ellipse_list == NULL)
 	return;
     if (ellipse == NULL)
 	return;
 
-    if (ellipse_list == &objects.ellipses)
+    if (ellipse_list == &objects.ellipses) {
 	remove_depth(O_ELLIPSE, ellipse->depth);
-    for (q = r = *ellipse_list; r != NULL; q = r, r = r->next) {
-	if (r == ellipse) {
-	    if (r == *ellipse_list)
-		*ellipse_list = (*ellipse_list)->next;
-	    else
-		q->next = r->next;
-	    break;
+	snap_index_delete(ellipse, O_ELLIPSE);
+    }
+    if (find_pred(&ellipse_preds, *ellipse_list, ellipse, next_ellipse, &before)) {
+	q = (F_ellipse *) before;
+	if (ellipse_list == &objects.ellipses &&
+	    objects.last.ellipses_head == *ellipse_list) {
+		/* keep the last one right, see objects_last_*() */
+		if (objects.last.ellipses == ellipse)
+		    objects.last.ellipses = q;
+		if (q == NULL)
+		    objects.last.ellipses_head = ellipse->next;
 	}
+	pred_unlinked(&ellipse_preds, *ellipse_list, q, ellipse->next);
+	if (q == NULL)
+	    *ellipse_list = ellipse->next;
+	else
+	    q->next = ellipse->next;
     }
     ellipse->next = NULL;
 }
@@ -95,23 +319,33 @@ list_delete_ellipse(F_ellipse **ellipse_list, F_ellipse *ellipse)
 void
 list_delete_line(F_line **line_list, F_line *line)
 {
-    F_line	   *q, *r;
+    F_line	   *q;
+    void	   *before;
 
     if (*line_list == NULL)
 	return;
     if (line == NULL)
 	return;
 
-    if (line_list == &objects.lines)
+    if (line_list == &objects.lines) {
 	remove_depth(O_POLYLINE, line->depth);
-    for (q = r = *line_list; r != NULL; q = r, r = r->next) {
-	if (r == line) {
-	    if (r == *line_list)
-		*line_list = (*line_list)->next;
-	    else
-		q->next = r->next;
-	    break;
+	snap_index_delete(line, O_POLYLINE);
+    }
+    if (find_pred(&line_preds, *line_list, line, next_line, &before)) {
+	q = (F_line *) before;
+	if (line_list == &objects.lines &&
+	    objects.last.lines_head == *line_list) {
+		/* keep the last one right, see objects_last_*() */
+		if (objects.last.lines == line)
+		    objects.last.lines = q;
+		if (q == NULL)
+		    objects.last.lines_head = line->next;
 	}
+	pred_unlinked(&line_preds, *line_list, q, line->next);
+	if (q == NULL)
+	    *line_list = line->next;
+	else
+	    q->next = line->next;
     }
     line->next = NULL;
 }
@@ -119,23 +353,33 @@ list_delete_line(F_line **line_list, F_line *line)
 void
 list_delete_spline(F_spline **spline_list, F_spline *spline)
 {
-    F_spline	   *q, *r;
+    F_spline	   *q;
+    void	   *before;
 
     if (*spline_list == NULL)
 	return;
     if (spline == NULL)
 	return;
 
-    if (spline_list == &objects.splines)
+    if (spline_list == &objects.splines) {
 	remove_depth(O_SPLINE, spline->depth);
-    for (q = r = *spline_list; r != NULL; q = r, r = r->next) {
-	if (r == spline) {
-	    if (r == *spline_list)
-		*spline_list = (*spline_list)->next;
-	    else
-		q->next = r->next;
-	    break;
+	snap_index_delete(spline, O_SPLINE);
+    }
+    if (find_pred(&spline_preds, *spline_list, spline, next_spline, &before)) {
+	q = (F_spline *) before;
+	if (spline_list == &objects.splines &&
+	    objects.last.splines_head == *spline_list) {
+		/* keep the last one right, see objects_last_*() */
+		if (objects.last.splines == spline)
+		    objects.last.splines = q;
+		if (q == NULL)
+		    objects.last.splines_head = spline->next;
 	}
+	pred_unlinked(&spline_preds, *spline_list, q, spline->next);
+	if (q == NULL)
+	    *spline_list = spline->next;
+	else
+	    q->next = spline->next;
     }
     spline->next = NULL;
 }
@@ -143,30 +387,42 @@ list_delete_spline(F_spline **spline_list, F_spline *spline)
 void
 list_delete_text(F_text **text_list, F_text *text)
 {
-    F_text	   *q, *r;
+    F_text	   *q;
+    void	   *before;
 
     if (*text_list == NULL)
 	return;
     if (text == NULL)
 	return;
 
-    if (text_list == &objects.texts)
+    if (text_list == &objects.texts) {
 	remove_depth(O_TXT, text->depth);
-    for (q = r = *text_list; r != NULL; q = r, r = r->next)
-	if (r == text) {
-	    if (r == *text_list)
-		*text_list = text->next;
-	    else
-		q->next = text->next;
-	    break;
+	snap_index_delete(text, O_TXT);
+    }
+    if (find_pred(&text_preds, *text_list, text, next_text, &before)) {
+	q = (F_text *) before;
+	if (text_list == &objects.texts &&
+	    objects.last.texts_head == *text_list) {
+		/* keep the last one right, see objects_last_*() */
+		if (objects.last.texts == text)
+		    objects.last.texts = q;
+		if (q == NULL)
+		    objects.last.texts_head = text->next;
 	}
+	pred_unlinked(&text_preds, *text_list, q, text->next);
+	if (q == NULL)
+	    *text_list = text->next;
+	else
+	    q->next = text->next;
+    }
     text->next = NULL;
 }
 
 void
 list_delete_compound(F_compound **list, F_compound *compound)
 {
-    F_compound	   *c, *cc;
+    F_compound	   *cc;
+    void	   *before;
 
     if (*list == NULL)
 	return;
@@ -175,15 +431,21 @@ list_delete_compound(F_compound **list, F_compound *compound)
 
     if (list == &objects.compounds)
 	remove_compound_depth(compound IF_SLIDES_ARG(True));
-
-    for (cc = c = *list; c != NULL; cc = c, c = c->next) {
-	if (c == compound) {
-	    if (c == *list)
-		*list = (*list)->next;
-	    else
-		cc->next = c->next;
-	    break;
+    if (find_pred(&compound_preds, *list, compound, next_compound, &before)) {
+	cc = (F_compound *) before;
+	if (list == &objects.compounds &&
+	    objects.last.compounds_head == *list) {
+		/* keep the last one right, see objects_last_*() */
+		if (objects.last.compounds == compound)
+		    objects.last.compounds = cc;
+		if (cc == NULL)
+		    objects.last.compounds_head = compound->next;
 	}
+	pred_unlinked(&compound_preds, *list, cc, compound->next);
+	if (cc == NULL)
+	    *list = compound->next;
+	else
+	    cc->next = compound->next;
     }
     compound->next = NULL;
 }
@@ -304,15 +566,24 @@ list_add_arc(F_arc **list, F_arc *a)
     F_arc	   *aa;
 
     a->next = NULL;
-    if ((aa = last_arc(*list)) == NULL)
+    if (list == &objects.arcs)
+	aa = objects_last_arc();
+    else
+	aa = last_arc(*list);
+    if (aa == NULL)
 	*list = a;
     else
 	aa->next = a;
-    if (list == &objects.arcs)
+    pred_added(&arc_preds, *list, aa, a);
+    if (list == &objects.arcs) {
+	objects.last.arcs = a;
+	objects.last.arcs_head = *list;
+	snap_index_add(a, O_ARC);
 	while (a) {
 	    add_depth(O_ARC, a->depth);
 	    a = a->next;
 	}
+    }
 }
 
 void
@@ -321,15 +592,24 @@ list_add_ellipse(F_ellipse **list, F_ellipse *e)
     F_ellipse	   *ee;
 
     e->next = NULL;
-    if ((ee = last_ellipse(*list)) == NULL)
+    if (list == &objects.ellipses)
+	ee = objects_last_ellipse();
+    else
+	ee = last_ellipse(*list);
+    if (ee == NULL)
 	*list = e;
     else
 	ee->next = e;
-    if (list == &objects.ellipses)
+    pred_added(&ellipse_preds, *list, ee, e);
+    if (list == &objects.ellipses) {
+	objects.last.ellipses = e;
+	objects.last.ellipses_head = *list;
+	snap_index_add(e, O_ELLIPSE);
 	while (e) {
 	    add_depth(O_ELLIPSE, e->depth);
 	    e = e->next;
 	}
+    }
 }
 
 void
@@ -338,15 +618,24 @@ list_add_line(F_line **list, F_line *l)
     F_line	   *ll;
 
     l->next = NULL;
-    if ((ll = last_line(*list)) == NULL)
+    if (list == &objects.lines)
+	ll = objects_last_line();
+    else
+	ll = last_line(*list);
+    if (ll == NULL)
 	*list = l;
     else
 	ll->next = l;
-    if (list == &objects.lines)
+    pred_added(&line_preds, *list, ll, l);
+    if (list == &objects.lines) {
+	objects.last.lines = l;
+	objects.last.lines_head = *list;
+	snap_index_add(l, O_POLYLINE);
 	while (l) {
 	    add_depth(O_POLYLINE, l->depth);
 	    l = l->next;
 	}
+    }
 }
 
 void
@@ -355,15 +644,24 @@ list_add_spline(F_spline **list, F_spline *s)
     F_spline	   *ss;
 
     s->next = NULL;
-    if ((ss = last_spline(*list)) == NULL)
+    if (list == &objects.splines)
+	ss = objects_last_spline();
+    else
+	ss = last_spline(*list);
+    if (ss == NULL)
 	*list = s;
     else
 	ss->next = s;
-    if (list == &objects.splines)
+    pred_added(&spline_preds, *list, ss, s);
+    if (list == &objects.splines) {
+	objects.last.splines = s;
+	objects.last.splines_head = *list;
+	snap_index_add(s, O_SPLINE);
 	while (s) {
 	    add_depth(O_SPLINE, s->depth);
 	    s = s->next;
 	}
+    }
 }
 
 void
@@ -372,15 +670,24 @@ list_add_text(F_text **list, F_text *t)
     F_text	   *tt;
 
     t->next = NULL;
-    if ((tt = last_text(*list)) == NULL)
+    if (list == &objects.texts)
+	tt = objects_last_text();
+    else
+	tt = last_text(*list);
+    if (tt == NULL)
 	*list = t;
     else
 	tt->next = t;
-    if (list == &objects.texts)
+    pred_added(&text_preds, *list, tt, t);
+    if (list == &objects.texts) {
+	objects.last.texts = t;
+	objects.last.texts_head = *list;
+	snap_index_add(t, O_TXT);
 	while (t) {
 	    add_depth(O_TXT, t->depth);
 	    t = t->next;
 	}
+    }
 }
 
 void
@@ -389,12 +696,19 @@ list_add_compound(F_compound **list, F_compound *c)
     F_compound	   *cc;
 
     c->next = NULL;
-    if ((cc = last_compound(*list)) == NULL)
+    if (list == &objects.compounds)
+	cc = objects_last_compound();
+    else
+	cc = last_compound(*list);
+    if (cc == NULL)
 	*list = c;
     else
 	cc->next = c;
+    pred_added(&compound_preds, *list, cc, c);
 
     if (list == &objects.compounds) {
+	objects.last.compounds = c;
+	objects.last.compounds_head = *list;
 	while (c) {
 	    add_compound_depth(c);
 	    c = c->next;
@@ -699,6 +1013,161 @@ change_compound(F_compound *old_c, F_compound *new_c)
     set_modifiedflag();
 }
 
+/*
+ * The last object of each list of "objects" is remembered in objects.last
+ * with the head of the list it was found for, so adding to the end of
+ * the lists doesn't have to walk them each time.  It is only a starting
+ * point for finding the end, so objects added after it don't matter, and
+ * a different head means it is no good.  The list_delete_*() functions
+ * and cut_objects() keep it right; anything else that takes the last
+ * object out of a list without changing the head must call
+ * clear_last_objects().
+ */
+
+static F_arc *
+objects_last_arc(void)
+{
+    F_arc	   *tt;
+
+    if (objects.arcs == NULL)
+	return NULL;
+    if (objects.last.arcs_head == objects.arcs && objects.last.arcs != NULL)
+	tt = objects.last.arcs;
+    else
+	tt = objects.arcs;
+    for (; tt->next != NULL; tt = tt->next)
+	    ;
+    objects.last.arcs = tt;
+    objects.last.arcs_head = objects.arcs;
+    return tt;
+}
+
+static F_compound *
+objects_last_compound(void)
+{
+    F_compound	   *tt;
+
+    if (objects.compounds == NULL)
+	return NULL;
+    if (objects.last.compounds_head == objects.compounds && objects.last.compounds != NULL)
+	tt = objects.last.compounds;
+    else
+	tt = objects.compounds;
+    for (; tt->next != NULL; tt = tt->next)
+	    ;
+    objects.last.compounds = tt;
+    objects.last.compounds_head = objects.compounds;
+    return tt;
+}
+
+static F_ellipse *
+objects_last_ellipse(void)
+{
+    F_ellipse	   *tt;
+
+    if (objects.ellipses == NULL)
+	return NULL;
+    if (objects.last.ellipses_head == objects.ellipses && objects.last.ellipses != NULL)
+	tt = objects.last.ellipses;
+    else
+	tt = objects.ellipses;
+    for (; tt->next != NULL; tt = tt->next)
+	    ;
+    objects.last.ellipses = tt;
+    objects.last.ellipses_head = objects.ellipses;
+    return tt;
+}
+
+static F_line *
+objects_last_line(void)
+{
+    F_line	   *tt;
+
+    if (objects.lines == NULL)
+	return NULL;
+    if (objects.last.lines_head == objects.lines && objects.last.lines != NULL)
+	tt = objects.last.lines;
+    else
+	tt = objects.lines;
+    for (; tt->next != NULL; tt = tt->next)
+	    ;
+    objects.last.lines = tt;
+    objects.last.lines_head = objects.lines;
+    return tt;
+}
+
+static F_spline *
+objects_last_spline(void)
+{
+    F_spline	   *tt;
+
+    if (objects.splines == NULL)
+	return NULL;
+    if (objects.last.splines_head == objects.splines && objects.last.splines != NULL)
+	tt = objects.last.splines;
+    else
+	tt = objects.splines;
+    for (; tt->next != NULL; tt = tt->next)
+	    ;
+    objects.last.splines = tt;
+    objects.last.splines_head = objects.splines;
+    return tt;
+}
+
+static F_text *
+objects_last_text(void)
+{
+    F_text	   *tt;
+
+    if (objects.texts == NULL)
+	return NULL;
+    if (objects.last.texts_head == objects.texts && objects.last.texts != NULL)
+	tt = objects.last.texts;
+    else
+	tt = objects.texts;
+    for (; tt->next != NULL; tt = tt->next)
+	    ;
+    objects.last.texts = tt;
+    objects.last.texts_head = objects.texts;
+    return tt;
+}
+
+/* forget the last objects, they are found again when next needed */
+
+void
+clear_last_objects(F_compound *ob)
+{
+    lists_changed();
+    snap_index_clear();
+    ob->last.arcs = ob->last.arcs_head = NULL;
+    ob->last.compounds = ob->last.compounds_head = NULL;
+    ob->last.ellipses = ob->last.ellipses_head = NULL;
+    ob->last.lines = ob->last.lines_head = NULL;
+    ob->last.splines = ob->last.splines_head = NULL;
+    ob->last.texts = ob->last.texts_head = NULL;
+}
+
+/* if ob is "objects", its lists now end at tails (or start there if they were empty) */
+
+static void
+set_last_objects(F_compound *ob, F_compound *tails)
+{
+    if (ob != &objects)
+	return;
+    objects.last.arcs = tails->arcs ? tails->arcs : objects.arcs;
+    objects.last.arcs_head = objects.arcs;
+    objects.last.compounds = tails->compounds ? tails->compounds : objects.compounds;
+    objects.last.compounds_head = objects.compounds;
+    objects.last.ellipses = tails->ellipses ? tails->ellipses : objects.ellipses;
+    objects.last.ellipses_head = objects.ellipses;
+    objects.last.lines = tails->lines ? tails->lines : objects.lines;
+    objects.last.lines_head = objects.lines;
+    objects.last.splines = tails->splines ? tails->splines : objects.splines;
+    objects.last.splines_head = objects.splines;
+    objects.last.texts = tails->texts ? tails->texts : objects.texts;
+    objects.last.texts_head = objects.texts;
+}
+
 /* find the tails of all the object lists */
 
 void tail(F_compound *ob, F_compound *tails)
@@ -710,6 +1179,15 @@ void tail(F_compound *ob, F_compound *tails)
     F_spline	   *s;
     F_text	   *t;
 
+    if (ob == &objects) {
+	tails->arcs = objects_last_arc();
+	tails->compounds = objects_last_compound();
+	tails->ellipses = objects_last_ellipse();
+	tails->lines = objects_last_line();
+	tails->splines = objects_last_spline();
+	tails->texts = objects_last_text();
+	return;
+    }
     if (NULL != (a = ob->arcs))
 	for (; a->next != NULL; a = a->next)
 		;
@@ -743,6 +1221,38 @@ void tail(F_compound *ob, F_compound *tails)
  * defined prior to calling append.
  */
 
+/* add the objects in the lists starting with a, e, l, s and t to the snap index, or take them out */
+
+static void
+snap_index_lists(F_arc *a, F_ellipse *e, F_line *l, F_spline *s, F_text *t, Boolean add)
+{
+    for (; a != NULL; a = a->next)
+	if (add)
+	    snap_index_add(a, O_ARC);
+	else
+	    snap_index_delete(a, O_ARC);
+    for (; e != NULL; e = e->next)
+	if (add)
+	    snap_index_add(e, O_ELLIPSE);
+	else
+	    snap_index_delete(e, O_ELLIPSE);
+    for (; l != NULL; l = l->next)
+	if (add)
+	    snap_index_add(l, O_POLYLINE);
+	else
+	    snap_index_delete(l, O_POLYLINE);
+    for (; s != NULL; s = s->next)
+	if (add)
+	    snap_index_add(s, O_SPLINE);
+	else
+	    snap_index_delete(s, O_SPLINE);
+    for (; t != NULL; t = t->next)
+	if (add)
+	    snap_index_add(t, O_TXT);
+	else
+	    snap_index_delete(t, O_TXT);
+}
+
 void append_objects(F_compound *l1, F_compound *l2, F_compound *tails)
 {
     /* don't forget to account for the depths */
@@ -772,12 +1282,22 @@ void append_objects(F_compound *l1, F_compound *l2, F_compound *tails)
 	tails->texts->next = l2->texts;
     else
 	l1->texts = l2->texts;
+    set_last_objects(l1, tails);
+    if (l1 == &objects)
+	snap_index_lists(l2->arcs, l2->ellipses, l2->lines, l2->splines, l2->texts, True);
 }
 
 /* Cut is the dual of append. Update slides only if DO_UPDATE_SLIDES is set */
 void cut_objects(F_compound *objects, F_compound *tails
                  IF_SLIDES_ARG(Boolean do_update_slides))
 {
+    lists_changed();
+    /* the objects cut off are in the snap index if this is the figure */
+    snap_index_lists(tails->arcs ? tails->arcs->next : objects->arcs,
+		     tails->ellipses ? tails->ellipses->next : objects->ellipses,
+		     tails->lines ? tails->lines->next : objects->lines,
+		     tails->splines ? tails->splines->next : objects->splines,
+		     tails->texts ? tails->texts->next : objects->texts, False);
     if (tails->arcs) {
 	tails->arcs->next = NULL;
     } else if (objects->arcs) {
@@ -808,6 +1328,7 @@ void cut_objects(F_compound *objects, F_compound *tails
     } else if (objects->texts) {
 	objects->texts = NULL;
     }
+    set_last_objects(objects, tails);
 }
 
 void
@@ -1061,79 +1582,61 @@ search_sfactor(F_spline *spline, F_point *selected_point)
 F_arc	       *
 prev_arc(F_arc *list, F_arc *arc)
 {
-    F_arc	   *csr;
-
-    if (list == arc)
-	return NULL;
+    void	   *before;
 
-    for (csr = list; csr->next != arc; csr = csr->next)
-	    ;
-    return csr;
+    if (find_pred(&arc_preds, list, arc, next_arc, &before))
+	return (F_arc *) before;
+    return NULL;
 }
 
 F_compound     *
 prev_compound(F_compound *list, F_compound *compound)
 {
-    F_compound	   *csr;
-
-    if (list == compound)
-	return NULL;
+    void	   *before;
 
-    for (csr = list; csr->next != compound; csr = csr->next)
-	    ;
-    return csr;
+    if (find_pred(&compound_preds, list, compound, next_compound, &before))
+	return (F_compound *) before;
+    return NULL;
 }
 
 F_ellipse      *
 prev_ellipse(F_ellipse *list, F_ellipse *ellipse)
 {
-    F_ellipse	   *csr;
-
-    if (list == ellipse)
-	return NULL;
+    void	   *before;
 
-    for (csr = list; csr->next != ellipse; csr = csr->next)
-	    ;
-    return csr;
+    if (find_pred(&ellipse_preds, list, ellipse, next_ellipse, &before))
+	return (F_ellipse *) before;
+    return NULL;
 }
 
 F_line	       *
 prev_line(F_line *list, F_line *line)
 {
-    F_line	   *csr;
+    void	   *before;
 
-    if (list == line)
-	return NULL;
-
-    for (csr = list; csr->next != line; csr = csr->next)
-	    ;
-    return csr;
+    if (find_pred(&line_preds, list, line, next_line, &before))
+	return (F_line *) before;
+    return NULL;
 }
 
 F_spline       *
 prev_spline(F_spline *list, F_spline *spline)
 {
-    F_spline	   *csr;
-
-    if (list == spline)
-	return NULL;
+    void	   *before;
 
-    for (csr = list; csr->next != spline; csr = csr->next)
-	    ;
-    return csr;
+    if (find_pred(&spline_preds, list, spline, next_spline, &before))
+	return (F_spline *) before;
+    return NULL;
 }
 
 F_text	       *
 prev_text(F_text *list, F_text *text)
 {
-    F_text	   *csr;
-
-    if (list == text)
-	return NULL;
+    void	   *before;
 
-    for (csr = list; csr->next != text; csr = csr->next)
-	    ;
-    return csr;
+    if (find_pred(&text_preds, list, text, next_text, &before))
+	return (F_text *) before;
+    return NULL;
 }
 
 F_point	       *
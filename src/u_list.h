@@ -35,6 +35,8 @@ void		list_add_text(F_text **list, F_text *t);
 void		list_add_compound(F_compound **list, F_compound *c);
 void		add_depth(int type, int depth);
 void		add_compound_depth(F_compound *comp);
+void		clear_last_objects(F_compound *ob);
+void		lists_changed(void);
 
 F_line	       *last_line(F_line *list);
 F_arc	       *last_arc(F_arc *list);
@@ -38,8 +38,11 @@
 #include "u_bound.h"
 #include "u_elastic.h"
 #include "u_markers.h"
+#include "u_snapindex.h"
+#include "u_timing.h"
 #include "w_cursor.h"
 #include "w_rulers.h"
+#include "w_snap.h"
 
 /* EXPORTS */
 
@@ -345,6 +348,7 @@ redisplay_canvas(void)
 
     redisplay_region(0, 0, CANVAS_WD, CANVAS_HT);
     reset_rulers();
+    timing_phase("drawing the figure");
 }
 
 /* redisplay the object currently being created by the user (if any) */
@@ -463,6 +467,7 @@ void redisplay_region(int xmin, int ymin, int xmax, int ymax)
     clear_canvas();
     redisplay_objects(&objects);
     redisplay_curobj();
+    snap_redisplay_highlight();
     reset_clip_window();
     reset_cursor();
 }
@@ -582,6 +587,8 @@ void redisplay_ellipse(F_ellipse *e)
 {
     int		    xmin, ymin, xmax, ymax;
 
+    snap_index_update(e, O_ELLIPSE);
+
     ellipse_bound(e, &xmin, &ymin, &xmax, &ymax);
     redisplay_zoomed_region(xmin, ymin, xmax, ymax);
 }
@@ -591,6 +598,9 @@ void redisplay_ellipses(F_ellipse *e1, F_ellipse *e2)
     int		    xmin1, ymin1, xmax1, ymax1;
     int		    xmin2, ymin2, xmax2, ymax2;
 
+    snap_index_update(e1, O_ELLIPSE);
+    snap_index_update(e2, O_ELLIPSE);
+
     ellipse_bound(e1, &xmin1, &ymin1, &xmax1, &ymax1);
     ellipse_bound(e2, &xmin2, &ymin2, &xmax2, &ymax2);
     redisplay_regions(xmin1, ymin1, xmax1, ymax1, xmin2, ymin2, xmax2, ymax2);
@@ -601,6 +611,8 @@ void redisplay_arc(F_arc *a)
     int		    xmin, ymin, xmax, ymax;
     int		    cx, cy;
 
+    snap_index_update(a, O_ARC);
+
     arc_bound(a, &xmin, &ymin, &xmax, &ymax);
     /* if vertices (and center point) are shown, make sure to include them in the clip area */
     if (appres.shownums) {
@@ -630,6 +642,9 @@ void redisplay_arcs(F_arc *a1, F_arc *a2)
     int		    xmin1, ymin1, xmax1, ymax1;
     int		    xmin2, ymin2, xmax2, ymax2;
 
+    snap_index_update(a1, O_ARC);
+    snap_index_update(a2, O_ARC);
+
     arc_bound(a1, &xmin1, &ymin1, &xmax1, &ymax1);
     arc_bound(a2, &xmin2, &ymin2, &xmax2, &ymax2);
     redisplay_regions(xmin1, ymin1, xmax1, ymax1, xmin2, ymin2, xmax2, ymax2);
@@ -639,6 +654,8 @@ void redisplay_spline(F_spline *s)
 {
     int		    xmin, ymin, xmax, ymax;
 
+    snap_index_update(s, O_SPLINE);
+
     spline_bound(s, &xmin, &ymin, &xmax, &ymax);
     redisplay_zoomed_region(xmin, ymin, xmax, ymax);
 }
@@ -648,6 +665,9 @@ void redisplay_splines(F_spline *s1, F_spline *s2)
     int		    xmin1, ymin1, xmax1, ymax1;
     int		    xmin2, ymin2, xmax2, ymax2;
 
+    snap_index_update(s1, O_SPLINE);
+    snap_index_update(s2, O_SPLINE);
+
     spline_bound(s1, &xmin1, &ymin1, &xmax1, &ymax1);
     spline_bound(s2, &xmin2, &ymin2, &xmax2, &ymax2);
     redisplay_regions(xmin1, ymin1, xmax1, ymax1, xmin2, ymin2, xmax2, ymax2);
@@ -657,6 +677,8 @@ void redisplay_line(F_line *l)
 {
     int		    xmin, ymin, xmax, ymax;
 
+    snap_index_update(l, O_POLYLINE);
+
     line_bound(l, &xmin, &ymin, &xmax, &ymax);
     redisplay_zoomed_region(xmin, ymin, xmax, ymax);
 }
@@ -666,6 +688,9 @@ void redisplay_lines(F_line *l1, F_line *l2)
     int		    xmin1, ymin1, xmax1, ymax1;
     int		    xmin2, ymin2, xmax2, ymax2;
 
+    snap_index_update(l1, O_POLYLINE);
+    snap_index_update(l2, O_POLYLINE);
+
     line_bound(l1, &xmin1, &ymin1, &xmax1, &ymax1);
     line_bound(l2, &xmin2, &ymin2, &xmax2, &ymax2);
     redisplay_regions(xmin1, ymin1, xmax1, ymax1, xmin2, ymin2, xmax2, ymax2);
@@ -690,6 +715,8 @@ void redisplay_text(F_text *t)
     int		    xmin, ymin, xmax, ymax;
     int		    dum;
 
+    snap_index_update(t, O_TXT);
+
     text_bound(t, &xmin, &ymin, &xmax, &ymax,
 		&dum,&dum,&dum,&dum,&dum,&dum,&dum,&dum);
     redisplay_zoomed_region(xmin, ymin, xmax, ymax);
@@ -701,6 +728,9 @@ void redisplay_texts(F_text *t1, F_text *t2)
     int		    xmin2, ymin2, xmax2, ymax2;
     int		    dum;
 
+    snap_index_update(t1, O_TXT);
+    snap_index_update(t2, O_TXT);
+
     text_bound(t1, &xmin1, &ymin1, &xmax1, &ymax1,
 		&dum,&dum,&dum,&dum,&dum,&dum,&dum,&dum);
     text_bound(t2, &xmin2, &ymin2, &xmax2, &ymax2,
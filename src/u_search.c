@@ -149,6 +149,7 @@ next_ellipse_found(int x, int y, int tolerance, int *px, int *py, unsigned int s
 {
     double	    a, b, dx, dy;
     double	    dis, r, tol;
+    Boolean	    near;
 
     if (!ellipse_in_mask())
 	return False;
@@ -172,15 +173,19 @@ next_ellipse_found(int x, int y, int tolerance, int *px, int *py, unsigned int s
 	dy = y - e->center.y;
 	a = e->radiuses.x;
 	b = e->radiuses.y;
-	/* prevent sqrt(0) core dumps */
-	if (dx == 0 && dy == 0)
-	    dis = 0.0;		/* so we return below */
-	else
-	    dis = sqrt(dx * dx + dy * dy);
-	if (dis < tol) {
-	    *px = e->center.x;
-	    *py = e->center.y;
-	    return True;
+	/* the center and the whole outline are within the larger radius */
+	near = fabs(dx) <= max2(a, b) + tol && fabs(dy) <= max2(a, b) + tol;
+	if (near) {
+	    /* prevent sqrt(0) core dumps */
+	    if (dx == 0 && dy == 0)
+		dis = 0.0;		/* so we return below */
+	    else
+		dis = sqrt(dx * dx + dy * dy);
+	    if (dis < tol) {
+		*px = e->center.x;
+		*py = e->center.y;
+		return True;
+	    }
 	}
 	if (abs(x - e->start.x) <= tolerance && abs(y - e->start.y) <= tolerance) {
 	    *px = e->start.x;
@@ -192,6 +197,8 @@ next_ellipse_found(int x, int y, int tolerance, int *px, int *py, unsigned int s
 	    *py = e->end.y;
 	    return True;
 	}
+	if (!near)
+	    continue;
 	if (a * dy == 0 && b * dx == 0)
 	    r = 0.0;		/* prevent core dumps */
 	else {
@@ -363,6 +370,13 @@ next_compound_found(int x, int y, int tolerance, int *px, int *py, unsigned int
     tol2 = tolerance * tolerance;
 
     for (; c != NULL; c = (shift? prev_compound(objects.compounds, c): c->next), n++) {
+	/* only the frame is looked at, so skip compounds away from it first */
+	if (x < c->nwcorner.x - tolerance || x > c->secorner.x + tolerance ||
+	    y < c->nwcorner.y - tolerance || y > c->secorner.y + tolerance)
+		continue;
+	if (x > c->nwcorner.x + tolerance && x < c->secorner.x - tolerance &&
+	    y > c->nwcorner.y + tolerance && y < c->secorner.y - tolerance)
+		continue;
 	if (!any_active_in_compound(c))
 		continue;
 	#ifdef SLIDES_SUPPORT
@@ -0,0 +1,606 @@
+/*
+ * FIG : Facility for Interactive Generation of figures
+ * Copyright (c) 1985-1988 by Supoj Sutanthavibul
+ * Parts Copyright (c) 1989-2007 by Brian V. Smith
+ *
+ * Any party obtaining a copy of these files is granted, free of charge, a
+ * full and unrestricted irrevocable, world-wide, paid up, royalty-free,
+ * nonexclusive right and license to deal in this software and documentation
+ * files (the "Software"), including without limitation the rights to use,
+ * copy, modify, merge, publish distribute, sublicense and/or sell copies of
+ * the Software, and to permit persons who receive copies from any such
+ * party to do so, with the only requirement being that the above copyright
+ * and this permission notice remain intact.
+ *
+ */
+
+/*
+ * Index of the points that snapping goes to whatever the pointer and the
+ * current point are: the endpoints, midpoints and foci (or centers) of the
+ * objects at the top level of the figure, as w_snap.c finds them.  Each of
+ * the three has a k-d tree of its points, so the point nearest the pointer
+ * is found quickly enough to be shown while the pointer moves.
+ *
+ * The index is made when first needed and then kept up to date one object
+ * at a time: list_add_*(), list_delete_*(), append_objects() and
+ * cut_objects() add and remove the points of objects, and redisplaying an
+ * object, which is done after it is changed, takes its points again.
+ * Points added since the tree was made are searched one by one until there
+ * are enough of them to make the tree again.  When the lists are replaced
+ * by hand, clear_last_objects() throws the whole index away.  Last, the
+ * point found is taken again from its object before it is used.
+ */
+
+#include "fig.h"
+#include "resources.h"
+#include "mode.h"
+#include "object.h"
+#include "u_snapindex.h"
+#include "w_intersect.h"
+#include "w_layers.h"
+#include "w_snap.h"
+#ifdef SLIDES_SUPPORT
+#include "w_slides.h"
+#endif
+
+#include <math.h>
+
+#define ENDPOINTS	0
+#define MIDPOINTS	1
+#define FOCI		2
+#define NKINDS		3
+
+struct snap_point {
+    int		    x, y;
+    void	   *obj;
+    int		    type;	/* O_POLYLINE etc. */
+    int		    depth;
+    unsigned int    stamp;	/* of obj when the point was taken */
+};
+
+struct snap_tree {
+    struct snap_point *points;
+    int		    npoints, maxpoints;
+    int		    ntree;	/* the first ntree points are in k-d order */
+    int		    ndead;	/* about how many are of old objects */
+};
+
+static struct snap_tree trees[NKINDS];
+static Boolean	index_made = False;
+
+/* the stamp of each object in the index, 0 once it has been taken out */
+static void   **stamp_objs = NULL;
+static unsigned int *stamps = NULL;
+static int	stamp_size = 0, stamp_count = 0;
+static unsigned int last_stamp = 0;
+
+/* what is done with each point of an object, see object_points() */
+static void	(*take_point)(int kind, int x, int y);
+static void    *pt_obj;
+static int	pt_type, pt_depth;
+static unsigned int pt_stamp;
+static int	match_kind, match_x, match_y, npoints_found;
+
+/* the search */
+static struct snap_point *best;
+static double	best_d2;
+static int	search_x, search_y;
+
+static int
+snap_kind(int mode)
+{
+    switch (mode) {
+      case SNAP_MODE_ENDPOINT:
+	return ENDPOINTS;
+      case SNAP_MODE_MIDPOINT:
+	return MIDPOINTS;
+      case SNAP_MODE_FOCUS:
+	return FOCI;
+    }
+    return -1;
+}
+
+/**********************************/
+/* the stamps, hashed by address  */
+/**********************************/
+
+static int
+stamp_slot(void *obj)
+{
+    unsigned long   h;
+    int		    i;
+
+    h = ((unsigned long) obj >> 3) * 2654435761UL;
+    for (i = (int) ((h ^ (h >> 16)) & (stamp_size - 1));
+	 stamp_objs[i] != NULL && stamp_objs[i] != obj; i = (i + 1) & (stamp_size - 1))
+	    ;
+    return i;
+}
+
+static unsigned int
+stamp_of(void *obj)
+{
+    int		    i;
+
+    i = stamp_slot(obj);
+    return stamp_objs[i] == obj ? stamps[i] : 0;
+}
+
+/* False if the table is too full, then the index must be made again */
+
+static Boolean
+set_stamp(void *obj, unsigned int stamp)
+{
+    int		    i;
+
+    i = stamp_slot(obj);
+    if (stamp_objs[i] == NULL) {
+	if (2 * (stamp_count + 1) > stamp_size)
+	    return False;
+	stamp_objs[i] = obj;
+	stamp_count++;
+    }
+    stamps[i] = stamp;
+    return True;
+}
+
+/*************************************/
+/* the points of an object, as found */
+/* by the handlers in w_snap.c	     */
+/*************************************/
+
+static void
+line_points(F_line *l)
+{
+    F_point	   *p, *prev;
+    double	    sx, sy;
+    int		    n;
+
+    for (prev = NULL, p = l->points; p != NULL; prev = p, p = p->next) {
+	(*take_point)(ENDPOINTS, p->x, p->y);
+	if (prev != NULL)
+	    (*take_point)(MIDPOINTS, (int) rint(((double) (p->x + prev->x)) / 2.0),
+				     (int) rint(((double) (p->y + prev->y)) / 2.0));
+    }
+    /* the first point of a closed line is also the last */
+    p = l->points;
+    if (p != NULL && l->type != T_POLYLINE)
+	p = p->next;
+    for (sx = sy = 0.0, n = 0; p != NULL; p = p->next, n++) {
+	sx += (double) p->x;
+	sy += (double) p->y;
+    }
+    if (n > 0)
+	(*take_point)(FOCI, (int) rint(sx / (double) n), (int) rint(sy / (double) n));
+}
+
+static void
+spline_points(F_spline *s)
+{
+    F_point	   *p;
+    double	    sx, sy;
+    int		    n;
+
+    /* splines only have their centroid, taken as for an open polyline */
+    for (sx = sy = 0.0, n = 0, p = s->points; p != NULL; p = p->next, n++) {
+	sx += (double) p->x;
+	sy += (double) p->y;
+    }
+    if (n > 0)
+	(*take_point)(FOCI, (int) rint(sx / (double) n), (int) rint(sy / (double) n));
+}
+
+static void
+text_points(F_text *t)
+{
+    F_line	   *box;
+
+    box = build_text_bounding_box(t);
+    line_points(box);
+    delete_text_bounding_box(box);
+}
+
+static void
+arc_points(F_arc *a)
+{
+    int		    i, sx, sy;
+
+    for (sx = sy = i = 0; i < 3; i++) {
+	(*take_point)(ENDPOINTS, a->point[i].x, a->point[i].y);
+	sx += a->point[i].x;
+	sy += a->point[i].y;
+    }
+    (*take_point)(MIDPOINTS, (int) rint(((double) sx) / 3.0), (int) rint(((double) sy) / 3.0));
+    (*take_point)(FOCI, (int) rint((double) a->center.x), (int) rint((double) a->center.y));
+}
+
+static void
+ellipse_points(F_ellipse *e)
+{
+    double	    rx, ry, xx, xy, c;
+    int		    i, idx, idy;
+
+    (*take_point)(MIDPOINTS, e->center.x, e->center.y);
+    if (e->type == T_CIRCLE_BY_RAD || e->type == T_CIRCLE_BY_DIA) {
+	(*take_point)(FOCI, e->center.x, e->center.y);
+	return;
+    }
+    /* the ends of the semi-axes */
+    for (i = 0; i < 4; i++) {
+	xx = (double) ((i & 1) ? 0 : ((i & 2) ? e->radiuses.x : -(e->radiuses.x)));
+	xy = (double) ((i & 1) ? ((i & 2) ? e->radiuses.y : -(e->radiuses.y)) : 0);
+	snap_rotate_vector(&rx, &ry, xx, xy, -((double) e->angle));
+	(*take_point)(ENDPOINTS, (int) rint(rx + (double) e->center.x),
+				 (int) rint(ry + (double) e->center.y));
+    }
+    c = sqrt(fabs(pow((double) e->radiuses.y, 2.0) - pow((double) e->radiuses.x, 2.0)));
+    snap_rotate_vector(&rx, &ry, c, 0.0, -((double) e->angle));
+    idx = (int) rint(rx);
+    idy = (int) rint(ry);
+    (*take_point)(FOCI, e->center.x + idx, e->center.y + idy);
+    (*take_point)(FOCI, e->center.x - idx, e->center.y - idy);
+}
+
+static int
+object_depth(void *obj, int type)
+{
+    switch (type) {
+      case O_ELLIPSE:
+	return ((F_ellipse *) obj)->depth;
+      case O_POLYLINE:
+	return ((F_line *) obj)->depth;
+      case O_SPLINE:
+	return ((F_spline *) obj)->depth;
+      case O_TXT:
+	return ((F_text *) obj)->depth;
+      case O_ARC:
+	return ((F_arc *) obj)->depth;
+    }
+    return 0;
+}
+
+/* call take_point() for each point of obj */
+
+static void
+object_points(void *obj, int type, void (*take)(int kind, int x, int y))
+{
+    take_point = take;
+    pt_obj = obj;
+    pt_type = type;
+    pt_depth = object_depth(obj, type);
+    switch (type) {
+      case O_ELLIPSE:
+	ellipse_points((F_ellipse *) obj);
+	break;
+      case O_POLYLINE:
+	line_points((F_line *) obj);
+	break;
+      case O_SPLINE:
+	spline_points((F_spline *) obj);
+	break;
+      case O_TXT:
+	text_points((F_text *) obj);
+	break;
+      case O_ARC:
+	arc_points((F_arc *) obj);
+	break;
+    }
+}
+
+static void
+add_point(int kind, int x, int y)
+{
+    struct snap_tree *tr = &trees[kind];
+    struct snap_point *pts;
+    int		    max;
+
+    if (tr->npoints >= tr->maxpoints) {
+	max = tr->maxpoints ? 2 * tr->maxpoints : 1024;
+	if ((pts = (struct snap_point *) realloc(tr->points,
+				max * sizeof(struct snap_point))) == NULL) {
+	    /* make it all again when next needed */
+	    index_made = False;
+	    return;
+	}
+	tr->points = pts;
+	tr->maxpoints = max;
+    }
+    pts = &tr->points[tr->npoints++];
+    pts->x = x;
+    pts->y = y;
+    pts->obj = pt_obj;
+    pts->type = pt_type;
+    pts->depth = pt_depth;
+    pts->stamp = pt_stamp;
+}
+
+static void
+count_point(int kind, int x, int y)
+{
+    trees[kind].ndead++;
+}
+
+static void
+match_point(int kind, int x, int y)
+{
+    if (kind == match_kind && x == match_x && y == match_y)
+	npoints_found++;
+}
+
+/* put obj in the index with a new stamp, its old points are then dead */
+
+static void
+add_object(void *obj, int type)
+{
+    pt_stamp = ++last_stamp;
+    if (!set_stamp(obj, pt_stamp)) {
+	index_made = False;
+	return;
+    }
+    object_points(obj, type, add_point);
+}
+
+/*****************/
+/* the k-d trees */
+/*****************/
+
+static int
+coord(struct snap_point *p, int axis)
+{
+    return axis ? p->y : p->x;
+}
+
+/* move the kth point of pts[lo..hi) by the axis into place, smaller ones before it */
+
+static void
+select_point(struct snap_point *pts, int lo, int hi, int k, int axis)
+{
+    struct snap_point tmp;
+    int		    i, j, pivot;
+
+    hi--;
+    while (lo < hi) {
+	pivot = coord(&pts[(lo + hi) / 2], axis);
+	i = lo;
+	j = hi;
+	while (i <= j) {
+	    while (coord(&pts[i], axis) < pivot)
+		i++;
+	    while (coord(&pts[j], axis) > pivot)
+		j--;
+	    if (i <= j) {
+		tmp = pts[i];
+		pts[i] = pts[j];
+		pts[j] = tmp;
+		i++;
+		j--;
+	    }
+	}
+	if (k <= j)
+	    hi = j;
+	else if (k >= i)
+	    lo = i;
+	else
+	    return;
+    }
+}
+
+static void
+build_tree(struct snap_point *pts, int lo, int hi, int axis)
+{
+    int		    mid;
+
+    if (hi - lo <= 1)
+	return;
+    mid = (lo + hi) / 2;
+    select_point(pts, lo, hi, mid, axis);
+    build_tree(pts, lo, mid, !axis);
+    build_tree(pts, mid + 1, hi, !axis);
+}
+
+/* drop the dead points and put all the others in the tree */
+
+static void
+remake_tree(struct snap_tree *tr)
+{
+    int		    i, n;
+
+    for (i = n = 0; i < tr->npoints; i++)
+	if (stamp_of(tr->points[i].obj) == tr->points[i].stamp)
+	    tr->points[n++] = tr->points[i];
+    tr->npoints = tr->ntree = n;
+    tr->ndead = 0;
+    build_tree(tr->points, 0, n, 0);
+}
+
+static void
+look_at(struct snap_point *p)
+{
+    double	    dx, dy, d2;
+
+    dx = (double) (p->x - search_x);
+    dy = (double) (p->y - search_y);
+    d2 = dx * dx + dy * dy;
+    if (d2 > best_d2)
+	return;
+    if (stamp_of(p->obj) != p->stamp || !active_layer(p->depth))
+	return;
+#ifdef SLIDES_SUPPORT
+    if (!active_object_slides(p->obj, p->type))
+	return;
+#endif
+    best = p;
+    best_d2 = d2;
+}
+
+static void
+search_tree(struct snap_point *pts, int lo, int hi, int axis)
+{
+    int		    mid, d;
+
+    if (lo >= hi)
+	return;
+    mid = (lo + hi) / 2;
+    look_at(&pts[mid]);
+    d = axis ? search_y - pts[mid].y : search_x - pts[mid].x;
+    if (d < 0) {
+	search_tree(pts, lo, mid, !axis);
+	if ((double) d * d <= best_d2)
+	    search_tree(pts, mid + 1, hi, !axis);
+    } else {
+	search_tree(pts, mid + 1, hi, !axis);
+	if ((double) d * d <= best_d2)
+	    search_tree(pts, lo, mid, !axis);
+    }
+}
+
+/* make the index from the objects of the figure */
+
+static Boolean
+make_index(void)
+{
+    F_arc	   *a;
+    F_ellipse	   *e;
+    F_line	   *l;
+    F_spline	   *s;
+    F_text	   *t;
+    void	  **objs;
+    unsigned int   *st;
+    int		    i, n, size;
+
+    for (n = 0, a = objects.arcs; a != NULL; a = a->next)
+	n++;
+    for (e = objects.ellipses; e != NULL; e = e->next)
+	n++;
+    for (l = objects.lines; l != NULL; l = l->next)
+	n++;
+    for (s = objects.splines; s != NULL; s = s->next)
+	n++;
+    for (t = objects.texts; t != NULL; t = t->next)
+	n++;
+    for (size = 256; size < 4 * n; size *= 2)
+	;
+    if (size != stamp_size) {
+	if ((objs = (void **) realloc(stamp_objs, size * sizeof(void *))) == NULL)
+	    return False;
+	stamp_objs = objs;
+	if ((st = (unsigned int *) realloc(stamps, size * sizeof(unsigned int))) == NULL)
+	    return False;
+	stamps = st;
+	stamp_size = size;
+    }
+    for (i = 0; i < size; i++)
+	stamp_objs[i] = NULL;
+    stamp_count = 0;
+    for (i = 0; i < NKINDS; i++)
+	trees[i].npoints = trees[i].ntree = trees[i].ndead = 0;
+
+    index_made = True;
+    for (a = objects.arcs; a != NULL; a = a->next)
+	add_object(a, O_ARC);
+    for (e = objects.ellipses; e != NULL; e = e->next)
+	add_object(e, O_ELLIPSE);
+    for (l = objects.lines; l != NULL; l = l->next)
+	add_object(l, O_POLYLINE);
+    for (s = objects.splines; s != NULL; s = s->next)
+	add_object(s, O_SPLINE);
+    for (t = objects.texts; t != NULL; t = t->next)
+	add_object(t, O_TXT);
+    if (!index_made)
+	return False;
+    for (i = 0; i < NKINDS; i++)
+	remake_tree(&trees[i]);
+    return True;
+}
+
+/*******************/
+/* public routines */
+/*******************/
+
+/* obj has been added to the top level of the figure */
+
+void
+snap_index_add(void *obj, int type)
+{
+    if (index_made && stamp_of(obj) == 0)
+	add_object(obj, type);
+}
+
+/* obj has been taken out of the top level of the figure */
+
+void
+snap_index_delete(void *obj, int type)
+{
+    if (!index_made || stamp_of(obj) == 0)
+	return;
+    object_points(obj, type, count_point);
+    (void) set_stamp(obj, 0);
+}
+
+/* obj may have been changed, take its points again if it is in the index */
+
+void
+snap_index_update(void *obj, int type)
+{
+    if (!index_made || stamp_of(obj) == 0)
+	return;
+    object_points(obj, type, count_point);
+    add_object(obj, type);
+}
+
+/* the lists have been changed by hand, make the index again when next needed */
+
+void
+snap_index_clear(void)
+{
+    index_made = False;
+}
+
+/*
+ * Find the point for the snap mode nearest (x, y), no farther than tol.
+ * False if there is none or the mode doesn't snap to fixed points.
+ */
+
+Boolean
+snap_index_nearest(int mode, int x, int y, int tol, int *px, int *py)
+{
+    struct snap_tree *tr;
+    int		    kind, i, tries;
+
+    if ((kind = snap_kind(mode)) < 0)
+	return False;
+    if (!index_made && !make_index())
+	return False;
+    tr = &trees[kind];
+    for (tries = 0; tries < 8; tries++) {
+	if (tr->npoints - tr->ntree > 64 + tr->ntree / 8 ||
+	    tr->ndead > 64 + tr->ntree / 2)
+		remake_tree(tr);
+	best = NULL;
+	best_d2 = (double) tol * tol;
+	search_x = x;
+	search_y = y;
+	search_tree(tr->points, 0, tr->ntree, 0);
+	for (i = tr->ntree; i < tr->npoints; i++)
+	    look_at(&tr->points[i]);
+	if (best == NULL)
+	    return False;
+
+	/* make sure the object still has the point */
+	match_kind = kind;
+	match_x = best->x;
+	match_y = best->y;
+	npoints_found = 0;
+	object_points(best->obj, best->type, match_point);
+	if (npoints_found > 0 && pt_depth == best->depth) {
+	    *px = best->x;
+	    *py = best->y;
+	    return True;
+	}
+	/* it was changed without being redisplayed, take its points again */
+	snap_index_update(best->obj, best->type);
+	if (!index_made)
+	    return False;
+    }
+    return False;
+}
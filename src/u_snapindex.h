@@ -0,0 +1,26 @@
+/*
+ * FIG : Facility for Interactive Generation of figures
+ * Copyright (c) 1985-1988 by Supoj Sutanthavibul
+ * Parts Copyright (c) 1989-2007 by Brian V. Smith
+ *
+ * Any party obtaining a copy of these files is granted, free of charge, a
+ * full and unrestricted irrevocable, world-wide, paid up, royalty-free,
+ * nonexclusive right and license to deal in this software and documentation
+ * files (the "Software"), including without limitation the rights to use,
+ * copy, modify, merge, publish distribute, sublicense and/or sell copies of
+ * the Software, and to permit persons who receive copies from any such
+ * party to do so, with the only requirement being that the above copyright
+ * and this permission notice remain intact.
+ *
+ */
+
+#ifndef U_SNAPINDEX_H
+#define U_SNAPINDEX_H
+
+extern void	snap_index_add(void *obj, int type);
+extern void	snap_index_delete(void *obj, int type);
+extern void	snap_index_update(void *obj, int type);
+extern void	snap_index_clear(void);
+extern Boolean	snap_index_nearest(int mode, int x, int y, int tol, int *px, int *py);
+
+#endif /* U_SNAPINDEX_H */
@@ -0,0 +1,278 @@
+/*
+ * FIG : Facility for Interactive Generation of figures
+ * Copyright (c) 1985-1988 by Supoj Sutanthavibul
+ * Parts Copyright (c) 1989-2007 by Brian V. Smith
+ *
+ * Any party obtaining a copy of these files is granted, free of charge, a
+ * full and unrestricted irrevocable, world-wide, paid up, royalty-free,
+ * nonexclusive right and license to deal in this software and documentation
+ * files (the "Software"), including without limitation the rights to use,
+ * copy, modify, merge, publish distribute, sublicense and/or sell copies of
+ * the Software, and to permit persons who receive copies from any such
+ * party to do so, with the only requirement being that the above copyright
+ * and this permission notice remain intact.
+ *
+ */
+
+/*
+ * Time taken by starting xfig, reported with -timing or -timing_file.
+ *
+ * Starting is cut into phases; each call of timing_phase() ends the phase
+ * of that name.  Work that is spread over the phases (e.g. reading the
+ * pictures) is added up by name with timing_add().  After the report is
+ * made nothing more is recorded.
+ *
+ * With -timing_edits the bounds of the compounds and some editing of the
+ * figure are timed too, after it has been drawn.  This changes the figure, so it is only for benchmarks.
+ */
+
+#include "fig.h"
+#include "resources.h"
+#include "mode.h"
+#include "object.h"
+#include "f_read.h"
+#include "u_bound.h"
+#include "u_free.h"
+#include "u_list.h"
+#include "u_redraw.h"
+#include "u_timing.h"
+#include "w_layers.h"
+#include "w_msgpanel.h"
+
+#ifdef HAVE_SYS_TIME_H
+#include <sys/time.h>
+#endif
+
+#define MAX_PHASES	16
+#define MAX_TOTALS	8
+
+struct timing {
+    char	   *name;
+    double	    secs;
+};
+
+static struct timing phases[MAX_PHASES];
+static struct timing totals[MAX_TOTALS];
+static int	nphases = 0, ntotals = 0;
+static double	phase_start = -1.0;
+static Boolean	reported = False;
+
+static Boolean	timing_on(void);
+
+/* seconds from some fixed time, from the monotonic clock where there is one */
+
+double
+timing_now(void)
+{
+#if defined(CLOCK_MONOTONIC)
+    struct timespec ts;
+
+    if (clock_gettime(CLOCK_MONOTONIC, &ts) == 0)
+	return ts.tv_sec + ts.tv_nsec / 1.0e9;
+#endif
+    {
+	struct timeval  tv;
+
+	gettimeofday(&tv, NULL);
+	return tv.tv_sec + tv.tv_usec / 1.0e6;
+    }
+}
+
+static Boolean
+timing_on(void)
+{
+    return appres.timing || (appres.timing_file && *appres.timing_file);
+}
+
+/* end the phase "name"; the first call, with name NULL, starts the clock */
+
+void
+timing_phase(char *name)
+{
+    double	    now;
+
+    if (reported)
+	return;
+    /* let the server catch up so its work is counted in this phase */
+    if (tool_d != NULL && timing_on())
+	XSync(tool_d, False);
+    now = timing_now();
+    if (name != NULL && phase_start >= 0.0 && nphases < MAX_PHASES) {
+	phases[nphases].name = name;
+	phases[nphases++].secs = now - phase_start;
+    }
+    phase_start = now;
+}
+
+/* add the time since "start" (from timing_now()) to the total "name" */
+
+void
+timing_add(char *name, double start)
+{
+    int		    i;
+
+    if (reported)
+	return;
+    for (i = 0; i < ntotals; i++)
+	if (strcmp(totals[i].name, name) == 0)
+	    break;
+    if (i == ntotals) {
+	if (ntotals == MAX_TOTALS)
+	    return;
+	totals[ntotals].name = name;
+	totals[ntotals++].secs = 0.0;
+    }
+    totals[i].secs += timing_now() - start;
+}
+
+/* bound c and the compounds in it, innermost first, as reading them does */
+
+static void
+bound_compound(F_compound *c)
+{
+    F_compound	   *cc;
+
+    for (cc = c->compounds; cc != NULL; cc = cc->next)
+	bound_compound(cc);
+    compound_bound(c, &c->nwcorner.x, &c->nwcorner.y,
+			&c->secorner.x, &c->secorner.y);
+}
+
+/*
+ * Tag every other object at the top level of the figure and delete the
+ * tagged ones one by one, as deleting a big selection would.
+ */
+
+static void
+delete_tagged(void)
+{
+    F_arc	   *a, *anext, *arcs = NULL;
+    F_compound	   *c, *cnext, *compounds = NULL;
+    F_ellipse	   *e, *enext, *ellipses = NULL;
+    F_line	   *l, *lnext, *lines = NULL;
+    F_spline	   *s, *snext, *splines = NULL;
+    F_text	   *t, *tnext, *texts = NULL;
+    int		    n = 0;
+
+    for (a = objects.arcs; a != NULL; a = a->next)
+	a->tagged = n++ & 1;
+    for (c = objects.compounds; c != NULL; c = c->next)
+	c->tagged = n++ & 1;
+    for (e = objects.ellipses; e != NULL; e = e->next)
+	e->tagged = n++ & 1;
+    for (l = objects.lines; l != NULL; l = l->next)
+	l->tagged = n++ & 1;
+    for (s = objects.splines; s != NULL; s = s->next)
+	s->tagged = n++ & 1;
+    for (t = objects.texts; t != NULL; t = t->next)
+	t->tagged = n++ & 1;
+
+    /* the layer buttons are drawn once, at the end */
+    defer_update_layers++;
+    for (a = objects.arcs; a != NULL; a = anext) {
+	anext = a->next;
+	if (a->tagged) {
+	    list_delete_arc(&objects.arcs, a);
+	    a->next = arcs;
+	    arcs = a;
+	}
+    }
+    for (c = objects.compounds; c != NULL; c = cnext) {
+	cnext = c->next;
+	if (c->tagged) {
+	    list_delete_compound(&objects.compounds, c);
+	    c->next = compounds;
+	    compounds = c;
+	}
+    }
+    for (e = objects.ellipses; e != NULL; e = enext) {
+	enext = e->next;
+	if (e->tagged) {
+	    list_delete_ellipse(&objects.ellipses, e);
+	    e->next = ellipses;
+	    ellipses = e;
+	}
+    }
+    for (l = objects.lines; l != NULL; l = lnext) {
+	lnext = l->next;
+	if (l->tagged) {
+	    list_delete_line(&objects.lines, l);
+	    l->next = lines;
+	    lines = l;
+	}
+    }
+    for (s = objects.splines; s != NULL; s = snext) {
+	snext = s->next;
+	if (s->tagged) {
+	    list_delete_spline(&objects.splines, s);
+	    s->next = splines;
+	    splines = s;
+	}
+    }
+    for (t = objects.texts; t != NULL; t = tnext) {
+	tnext = t->next;
+	if (t->tagged) {
+	    list_delete_text(&objects.texts, t);
+	    t->next = texts;
+	    texts = t;
+	}
+    }
+    defer_update_layers--;
+    update_layers();
+    timing_phase("deleting tagged objects");
+
+    free_arc(&arcs);
+    free_compound(&compounds);
+    free_ellipse(&ellipses);
+    free_line(&lines);
+    free_spline(&splines);
+    free_text(&texts);
+}
+
+/* with -timing_edits, time editing the figure that has been read */
+
+void
+timing_edits(void)
+{
+    F_compound	   *c;
+
+    if (reported || !appres.timing_edits || !timing_on())
+	return;
+    for (c = objects.compounds; c != NULL; c = c->next)
+	bound_compound(c);
+    timing_phase("bounding the compounds");
+    delete_tagged();
+    redisplay_canvas();
+}
+
+/* write the report to stderr, or append it to the timing_file */
+
+void
+timing_report(void)
+{
+    FILE	   *fp;
+    double	    total = 0.0;
+    int		    i;
+
+    if (reported)
+	return;
+    reported = True;
+    if (!timing_on())
+	return;
+    fp = stderr;
+    if (appres.timing_file && *appres.timing_file &&
+	(fp = fopen(appres.timing_file, "a")) == NULL) {
+	    file_msg("Can't open timing file %s: %s", appres.timing_file, strerror(errno));
+	    fp = stderr;
+    }
+    fprintf(fp, "xfig startup: %s\n", cur_filename[0]? cur_filename: "(no figure)");
+    for (i = 0; i < nphases; i++) {
+	fprintf(fp, "  %-28s %9.1f ms\n", phases[i].name, phases[i].secs*1000.0);
+	total += phases[i].secs;
+    }
+    fprintf(fp, "  %-28s %9.1f ms\n", "total", total*1000.0);
+    for (i = 0; i < ntotals; i++)
+	fprintf(fp, "  of which %-19s %9.1f ms\n", totals[i].name, totals[i].secs*1000.0);
+    if (fp != stderr)
+	fclose(fp);
+}
@@ -487,6 +487,8 @@ void undo_change(void)
 	swp_c = objects;
 	objects = saved_objects;
 	saved_objects = swp_c;
+	clear_last_objects(&objects);
+	clear_last_objects(&saved_objects);
 	new_c = &objects;
 	old_c = &saved_objects;
 	/* account for depths */
@@ -679,6 +681,8 @@ void undo_load(void)
     temp = objects;
     objects = saved_objects;
     saved_objects = temp;
+    clear_last_objects(&objects);
+    clear_last_objects(&saved_objects);
     /* swap filenames */
     strcpy(ctemp, cur_filename);
     update_cur_filename(save_filename);
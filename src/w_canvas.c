@@ -222,6 +222,38 @@ void setup_canvas(void)
     reset_clip_window();
 }
 
+/*
+ * Take the motion events for the same window that directly follow event
+ * off the queue and return the last of them, so a slow locmove proc or
+ * display doesn't fall behind the pointer.  Events of other types stop
+ * the scan so the order of presses and motions is kept.
+ */
+
+static long	motion_dropped = 0;	/* motion events skipped so far */
+
+static XMotionEvent *
+latest_motion(XMotionEvent *event)
+{
+    static XEvent   last;
+    XEvent	    next;
+    int		    n;
+
+    for (n = 0; XEventsQueued(event->display, QueuedAfterReading) > 0; n++) {
+	XPeekEvent(event->display, &next);
+	if (next.type != MotionNotify || next.xmotion.window != event->window)
+	    break;
+	XNextEvent(event->display, &last);
+	event = &last.xmotion;
+    }
+    if (n > 0) {
+	motion_dropped += n;
+	if (appres.DEBUG)
+	    fprintf(stderr, "skipped %d motion events (%ld in all)\n",
+			n, motion_dropped);
+    }
+    return event;
+}
+
 void canvas_selected(Widget tool, XButtonEvent *event, String *params, Cardinal *nparams)
 {
     KeySym	    key;
@@ -250,6 +282,9 @@ void canvas_selected(Widget tool, XButtonEvent *event, String *params, Cardinal
       /****************/
       case MotionNotify:
 
+	/* only the latest of the queued motion events matters */
+	event = (XButtonEvent *) latest_motion((XMotionEvent *) event);
+
 #if defined(SMOOTHMOTION)
 	/* translate from zoomed coords to object coords */
 	x = BACKX(event->x);
@@ -301,6 +336,7 @@ void canvas_selected(Widget tool, XButtonEvent *event, String *params, Cardinal
 #endif /* SMOOTHMOTION */
 
 	set_rulermark(x, y);
+	snap_highlight(x, y);
 	(*canvas_locmove_proc) (x, y);
 	break;
 
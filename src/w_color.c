@@ -260,6 +260,40 @@ void YStoreColors(Colormap colormap, XColor *color, int ncolors)
 	    YStoreColor(colormap,&color[i]);
 }
 
+/*
+ * Tables to compose a TrueColor/DirectColor pixel value from 8-bit
+ * red, green and blue values using the masks of the visual.
+ * See RGB_PIXEL() in w_color.h.
+ */
+
+unsigned long	red_pixtab[256], green_pixtab[256], blue_pixtab[256];
+Boolean		pixtabs_made = False;
+
+static void
+make_channel_tab(unsigned long *tab, unsigned long mask)
+{
+	int		 shift, bits, i;
+
+	for (shift = 0; shift < 32 && !(mask & 1); shift++)
+	    mask >>= 1;
+	for (bits = 0; mask & 1; bits++)
+	    mask >>= 1;
+	for (i = 0; i < 256; i++) {
+	    if (bits <= 8)
+		tab[i] = (unsigned long) (i >> (8 - bits)) << shift;
+	    else
+		tab[i] = (unsigned long) (i << (bits - 8)) << shift;
+	}
+}
+
+void make_pixtabs(void)
+{
+	make_channel_tab(red_pixtab, tool_v->red_mask);
+	make_channel_tab(green_pixtab, tool_v->green_mask);
+	make_channel_tab(blue_pixtab, tool_v->blue_mask);
+	pixtabs_made = True;
+}
+
 void create_color_panel(Widget form, Widget label, Widget cancel, ind_sw_info *isw)
 {
 	intptr_t	 i;
@@ -32,6 +32,16 @@ extern void pen_fill_activate (int func);
 extern void pick_contrast (XColor color, Widget widget);
 extern void restore_mixed_colors (void);
 extern void set_cmap (Window window);
+extern void make_pixtabs (void);
+
+/* True if pixel values can be computed from RGB values using the visual's masks */
+#define DIRECT_PIXELS	(tool_vclass == TrueColor || tool_vclass == DirectColor)
+
+/* pixel value of an 8-bit red, green, blue color when DIRECT_PIXELS is True */
+#define RGB_PIXEL(r,g,b) (red_pixtab[r] | green_pixtab[g] | blue_pixtab[b])
+
+extern	unsigned long	red_pixtab[256], green_pixtab[256], blue_pixtab[256];
+extern	Boolean		pixtabs_made;
 
 
 extern	Widget	delunusedColors;
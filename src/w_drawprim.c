@@ -67,8 +67,14 @@ static Boolean	inside (XPoint testVertex, int x1, int y1, int x2, int y2);
 static void	setup_next(int npoints, XPoint *in, XPoint *out);
 static Pixel	gc_color[NUMOPS], gc_background[NUMOPS];
 static XRectangle clip[1];
+static unsigned long clip_gen = 1;	/* bumped each time clip[] changes */
 static int	parsesize(char *name);
 static Boolean	openwinfonts;
+static Boolean	fonts_probed;		/* looked for scalable fonts yet */
+static Boolean	font_listed[NUM_FONTS];	/* listed the sizes of the family */
+static void	probe_fonts(void);
+static void	list_font_sizes(int f);
+static Boolean	list_fonts_work(XtPointer client_data);
 
 #define MAXNAMES 300
 
@@ -86,11 +92,6 @@ int SutherlandHodgmanPolygoClip (XPoint *inVertices, XPoint *outVertices, int in
 
 void init_font(void)
 {
-    struct xfont   *newfont, *nf;
-    int		    f, count, i, p, ss;
-    char	    template[300];
-    char	  **fontlist, **fname;
-
     if (appres.boldFont == NULL || *appres.boldFont == '\0')
 	appres.boldFont = BOLD_FONT;
     if (appres.normalFont == NULL || *appres.normalFont == '\0')
@@ -118,12 +119,29 @@ void init_font(void)
 		appres.buttonFont, appres.normalFont);
 	button_font = XLoadQueryFont(tool_d, appres.normalFont);
     }
+
     /*
-     * Now initialize the font structure for the X fonts corresponding to the
-     * Postscript fonts for the canvas.	 OpenWindows can use any LaserWriter
-     * fonts at any size, so we don't need to load anything if we are using
-     * it.
+     * The X fonts for the Postscript fonts on the canvas are looked for
+     * when first used (see find_xfont()), or else when xfig is idle, so
+     * that starting does not wait for the server to list them all.
      */
+    (void) XtAppAddWorkProc(tool_app, list_fonts_work, (XtPointer) NULL);
+}
+
+/*
+ * Initialize the font structure for the X fonts corresponding to the
+ * Postscript fonts for the canvas.  OpenWindows can use any LaserWriter
+ * fonts at any size, so we don't need to load anything if we are using it.
+ */
+
+static void
+probe_fonts(void)
+{
+    int		    f, count;
+    char	    template[300];
+    char	  **fontlist;
+
+    fonts_probed = True;
 
     /* if the user hasn't disallowed scalable fonts, check that the
        server really has them by checking for font of 0-0 size */
@@ -152,66 +170,95 @@ void init_font(void)
 	}
 	XFreeFontNames(fontlist);
     }
+}
 
-    /* no scalable fonts - query the server for all the font
-       names and sizes and build a list of them */
+/* no scalable fonts - query the server for all the font
+   names and sizes of family f and build a list of them */
 
-    if (!appres.scalablefonts) {
-	for (f = 0; f < NUM_FONTS; f++) {
-	    nf = NULL;
-	    strcpy(template,x_fontinfo[f].template);
-	    strcat(template,"*-*-*-*-*-*-");
-	    /* add ISO8859 (if not Symbol font or ZapfDingbats) to font name in non-international mode*/
-	    if (
+static void
+list_font_sizes(int f)
+{
+    struct xfont   *newfont, *nf;
+    int		    count, i, p, ss;
+    char	    template[300];
+    char	  **fontlist, **fname;
+
+    font_listed[f] = True;
+    nf = NULL;
+    strcpy(template,x_fontinfo[f].template);
+    strcat(template,"*-*-*-*-*-*-");
+    /* add ISO8859 (if not Symbol font or ZapfDingbats) to font name in non-international mode*/
+    if (
 #ifdef I18N
-		!appres.international &&
+	!appres.international &&
 #endif
-		strstr(template,"ymbol") == NULL &&
-		strstr(template,"ingbats") == NULL)
-		    strcat(template,"ISO8859-*");
-	    else
-		strcat(template,"*-*");
-	    /* don't free the Fontlist because we keep pointers into it */
-	    p = 0;
-	    if ((fontlist = XListFonts(tool_d, template, MAXNAMES, &count))==0) {
-		/* no fonts by that name found, substitute the -normal font name */
-		flist[p].fn = appres.normalFont;
-		flist[p++].s = 12;	/* just set the size to 12 */
-	    } else {
-		fname = fontlist; /* go through the list finding point
-				   * sizes */
-		while (count--) {
-		ss = parsesize(*fname);	/* get the point size from
-					 * the name */
-		flist[p].fn = *fname++;	/* save name of this size
-					 * font */
-		flist[p++].s = ss;	/* and save size */
-		}
+	strstr(template,"ymbol") == NULL &&
+	strstr(template,"ingbats") == NULL)
+	    strcat(template,"ISO8859-*");
+    else
+	strcat(template,"*-*");
+    /* don't free the Fontlist because we keep pointers into it */
+    p = 0;
+    if ((fontlist = XListFonts(tool_d, template, MAXNAMES, &count))==0) {
+	/* no fonts by that name found, substitute the -normal font name */
+	flist[p].fn = appres.normalFont;
+	flist[p++].s = 12;	/* just set the size to 12 */
+    } else {
+	fname = fontlist; /* go through the list finding point
+			   * sizes */
+	while (count--) {
+	ss = parsesize(*fname);	/* get the point size from
+				 * the name */
+	flist[p].fn = *fname++;	/* save name of this size
+				 * font */
+	flist[p++].s = ss;	/* and save size */
+	}
+    }
+    /* start at size 4 and go to 50 */
+    for (ss = 4; ss <= 50; ss++) {
+	for (i = 0; i < p; i++)
+		if (flist[i].s == ss)	/* found size */
+		    break;
+	/* if found size, allocate the font */
+	if (i < p && flist[i].s == ss) {
+		newfont = (struct xfont *) malloc(sizeof(struct xfont));
+		if (nf == NULL)
+		    x_fontinfo[f].xfontlist = newfont;
+		else
+		    nf->next = newfont;
+		nf = newfont;	/* keep current ptr */
+		nf->size = ss;	/* store the size here */
+		if (appres.DEBUG)
+		    fprintf(stderr,"Font: %s\n",flist[i].fn);
+		nf->fname = flist[i].fn;	/* keep actual name */
+		nf->bname = NULL;
+		nf->fstruct = NULL;
+		nf->fset = NULL;
+		nf->next = NULL;
 	    }
-	    /* start at size 4 and go to 50 */
-	    for (ss = 4; ss <= 50; ss++) {
-		for (i = 0; i < p; i++)
-			if (flist[i].s == ss)	/* found size */
-			    break;
-		/* if found size, allocate the font */
-		if (i < p && flist[i].s == ss) {
-			newfont = (struct xfont *) malloc(sizeof(struct xfont));
-			if (nf == NULL)
-			    x_fontinfo[f].xfontlist = newfont;
-			else
-			    nf->next = newfont;
-			nf = newfont;	/* keep current ptr */
-			nf->size = ss;	/* store the size here */
-			if (appres.DEBUG)
-			    fprintf(stderr,"Font: %s\n",flist[i].fn);
-			nf->fname = flist[i].fn;	/* keep actual name */
-			nf->fstruct = NULL;
-		        nf->fset = NULL;
-			nf->next = NULL;
-		    }
-	    } /* next size */
-	} /* next font, f */
-    } /* !appres.scalablefonts */
+    } /* next size */
+}
+
+/* work proc to find the canvas fonts one family at a time while idle */
+
+static Boolean
+list_fonts_work(XtPointer client_data)
+{
+    int		    f;
+
+    if (!fonts_probed) {
+	probe_fonts();
+	return False;
+    }
+    if (!appres.scalablefonts) {
+	for (f = 0; f < NUM_FONTS && font_listed[f]; f++)
+	    ;
+	if (f < NUM_FONTS) {
+	    list_font_sizes(f);
+	    return False;
+	}
+    }
+    return True;	/* done, remove the work proc */
 }
 
 /* parse the point size of font 'name' */
@@ -236,28 +283,34 @@ parsesize(char *name)
 }
 
 /*
- * Lookup an X font, "fnum" corresponding to a Postscript font style that is
- * close in size to "size"
+ * Fonts already looked up by lookfont(), by font number and (requested)
+ * size, so that neither the lists in x_fontinfo[] are searched nor the
+ * server asked again for a font we have.
  */
 
-XFontStruct *
-lookfont(int fnum, int size)
-{
-	XFontStruct    *fontst;
-	XFontSet        fontset = NULL;
-	char		fn[300],back_fn[300];
-	char		template[300], *sub;
-	Boolean		found;
-	struct xfont   *newfont, *nf, *oldnf;
+#define FONT_HASH_SIZE	256
+#define FONT_HASH(fnum,size)	(((unsigned int) (fnum) * 97 + (unsigned int) (size)) % FONT_HASH_SIZE)
+
+struct font_cache {
+    int		    fnum, size;
+    struct xfont   *nf;
+    struct font_cache *next;
+};
 
+static struct font_cache *font_hash[FONT_HASH_SIZE];
+
+static struct xfont	*find_xfont(int fnum, int size);
+static void		 load_xfont(struct xfont *nf);
+static void		 xfont_name(char *name, char *xtemplate, int size);
 #ifdef I18N
-	char **mcharset;
-	int ncharset;
-	char *defstr;
+static XFontSet		 make_fontset(char *fn);
 #endif
 
-	if (fnum == DEFAULT)
-	    fnum = 0;			/* pass back the -normal font font */
+/* the size lookfont() uses for "size" */
+
+static int
+lookfont_size(int size)
+{
 	if (size < 0)
 	    size = DEF_FONTSIZE;	/* default font size */
 	if (size < MIN_X_FONT_SIZE)
@@ -268,6 +321,167 @@ lookfont(int fnum, int size)
 	/* if user asks, adjust for correct font size */
 	if (appres.correct_font_size)
 	    size = round(size*80.0/72.0);
+	return size;
+}
+
+/*
+ * Lookup an X font, "fnum" corresponding to a Postscript font style that is
+ * close in size to "size"
+ */
+
+XFontStruct *
+lookfont(int fnum, int size)
+{
+	struct xfont   *nf;
+
+	if (fnum == DEFAULT)
+	    fnum = 0;			/* pass back the -normal font font */
+	nf = find_xfont(fnum, lookfont_size(size));
+
+	if (nf->fstruct == NULL) {
+	    /* if we are previewing a figure and the user pressed Cancel,
+	       return now with the simple roman font */
+	    if (check_cancel())
+		return roman_font;
+	    load_xfont(nf);
+	}
+	return (nf->fstruct);
+}
+
+/*
+ * Size of the font for drawing text of point size "size" at the current
+ * zoom.  When zoomed, the larger sizes are rounded to steps of about 4%
+ * (2 pixels up to 48, 4 up to 96 ...) so that zooming in and out does not
+ * make the server open a font for each new size.
+ */
+
+int
+zoomed_font_size(int size)
+{
+	int		step;
+
+	size = round(size*display_zoomscale);
+	if (display_zoomscale == 1.0)
+	    return size;
+	if (!fonts_probed)
+	    probe_fonts();
+	if (!appres.scalablefonts)
+	    return size;
+	for (step = 1; size > 24*step; step *= 2)
+	    ;
+	return (size + step/2) / step * step;
+}
+
+/*
+ * Load the X fonts for the fonts[i], sizes[i] pairs not loaded yet.  All
+ * fonts are opened before any is queried, and the ones that don't exist
+ * are found with a single XSync(), so the server does not wait for us
+ * between fonts.  Fonts that fail are left to load_xfont() to substitute.
+ */
+
+static unsigned long	*load_serials;	/* request numbers of the XLoadFont()s */
+static Boolean		*load_failed;
+static int		 load_count;
+
+static int
+font_error_handler(Display *dpy, XErrorEvent *err)
+{
+	int		i;
+
+	for (i = 0; i < load_count; i++)
+	    if (load_serials[i] == err->serial)
+		load_failed[i] = True;
+	return 0;
+}
+
+void
+load_xfonts(int n, int *fonts, int *sizes)
+{
+	struct xfont  **nfs;
+	Font	       *fids;
+	int		i, j, nload;
+	XErrorHandler	old_handler;
+
+	if (n <= 0)
+	    return;
+	nfs = (struct xfont **) malloc(n * sizeof(struct xfont *));
+	fids = (Font *) malloc(n * sizeof(Font));
+	load_serials = (unsigned long *) malloc(n * sizeof(unsigned long));
+	load_failed = (Boolean *) malloc(n * sizeof(Boolean));
+	nload = 0;
+	if (nfs && fids && load_serials && load_failed) {
+	    for (i = 0; i < n; i++) {
+		nfs[nload] = find_xfont(fonts[i] == DEFAULT? 0: fonts[i],
+				lookfont_size(sizes[i]));
+		if (nfs[nload]->fstruct != NULL)
+		    continue;
+		/* two sizes may map to the same font */
+		for (j = 0; j < nload; j++)
+		    if (nfs[j] == nfs[nload])
+			break;
+		if (j == nload)
+		    nload++;
+	    }
+	}
+
+	if (nload > 0) {
+	    set_temp_cursor(wait_cursor);
+	    if (appres.DEBUG)
+		fprintf(stderr,"Loading %d fonts\n", nload);
+	    /* only catch the errors of our own requests */
+	    XSync(tool_d, False);
+	    load_count = nload;
+	    old_handler = XSetErrorHandler(font_error_handler);
+	    for (i = 0; i < nload; i++) {
+		load_serials[i] = NextRequest(tool_d);
+		load_failed[i] = False;
+		fids[i] = XLoadFont(tool_d, nfs[i]->fname);
+	    }
+	    XSync(tool_d, False);
+	    XSetErrorHandler(old_handler);
+	    load_count = 0;
+
+	    for (i = 0; i < nload; i++) {
+		if (!load_failed[i] && (nfs[i]->fstruct = XQueryFont(tool_d, fids[i])) != NULL) {
+#ifdef I18N
+		    nfs[i]->fset = make_fontset(nfs[i]->fname);
+#endif
+		} else {
+		    /* try the other names, or substitute the normal font */
+		    load_xfont(nfs[i]);
+		}
+	    }
+	    reset_cursor();
+	}
+	free(nfs);
+	free(fids);
+	free(load_serials);
+	free(load_failed);
+	load_serials = NULL;
+	load_failed = NULL;
+}
+
+/* find (or make) the entry in x_fontinfo[fnum].xfontlist to use for "size" */
+
+static struct xfont *
+find_xfont(int fnum, int size)
+{
+	struct font_cache *fc;
+	char		fn[300],back_fn[300];
+	Boolean		found;
+	struct xfont   *newfont, *nf, *oldnf;
+	unsigned int	h;
+
+	h = FONT_HASH(fnum, size);
+	for (fc = font_hash[h]; fc != NULL; fc = fc->next)
+	    if (fc->fnum == fnum && fc->size == size)
+		return fc->nf;
+
+	/* find the fonts of this family if not done yet */
+	if (!fonts_probed)
+	    probe_fonts();
+	if (!appres.scalablefonts && !font_listed[fnum])
+	    list_font_sizes(fnum);
 
 	/* see if we've already loaded that font size 'size'
 	   from the font family 'fnum' */
@@ -294,12 +508,10 @@ lookfont(int fnum, int size)
 	    }
 	}
 	if (found) {		/* found exact size (or only larger available) */
-	    strcpy(fn,nf->fname);  /* put the name in fn */
 	    if (size < nf->size)
 		put_msg("Font size %d not found, using larger %d point",size,nf->size);
 	} else if (!appres.scalablefonts) {	/* not found, use largest available */
 	    nf = oldnf;
-	    strcpy(fn,nf->fname);		/* put the name in fn */
 	    if (size > nf->size)
 		put_msg("Font size %d not found, using smaller %d point",size,nf->size);
 	} else { /* scalablefonts; none yet of that size, alloc one and put it in the list */
@@ -318,38 +530,12 @@ lookfont(int fnum, int size)
 	    if (openwinfonts) {
 		/* OpenWindows fonts, create font name like times-roman-13 */
 		sprintf(fn, "%s-%d", x_fontinfo[fnum].template, size);
+		strcpy(back_fn, fn);
 	    } else {
 		/* X11 fonts, create a full XLFD font name */
-		strcpy(template,x_fontinfo[fnum].template);
-		/* attach pointsize to font name */
-		strcat(template,"%d-*-*-*-*-*-");
-		/* add ISO8859 (if not Symbol font or ZapfDingbats) to font name in non-international mode */
-		if (
-#ifdef I18N
-		    !appres.international &&
-#endif
-		    strstr(template,"ymbol") == NULL &&
-		    strstr(template,"ingbats") == NULL)
-			strcat(template,"ISO8859-*");
-	        else
-			strcat(template,"*-*");
-		/* use the pixel field instead of points in the fontname so that the
-		font scales with screen size */
-		sprintf(fn, template, size);
+		xfont_name(fn, x_fontinfo[fnum].template, size);
 		/* do same process with backup font name in case first doesn't exist */
-		strcpy(template,x_backup_fontinfo[fnum].template);
-		strcat(template,"%d-*-*-*-*-*-");
-		/* add ISO8859 (if not Symbol font or ZapfDingbats) to font name in non-international mode */
-		if (
-#ifdef I18N
-		    !appres.international &&
-#endif
-		    strstr(template,"ymbol") == NULL &&
-		    strstr(template,"ingbats") == NULL)
-			strcat(template,"ISO8859-*");
-	        else
-			strcat(template,"*-*");
-		sprintf(back_fn, template, size);
+		xfont_name(back_fn, x_backup_fontinfo[fnum].template, size);
 	    }
 	    /* allocate space for the name and put it in the structure */
 	    nf->fname = (char *) new_string(max2(strlen(fn),strlen(back_fn)));
@@ -359,68 +545,120 @@ lookfont(int fnum, int size)
 	    strcpy(nf->bname, back_fn);
 	} /* scalable */
 
-	if (nf->fstruct == NULL) {
-	    if (appres.DEBUG)
-		fprintf(stderr,"Loading font %s\n",fn);
-	    /* if we are previewing a figure and the user pressed Cancel,
-	       return now with the simple roman font */
-	    if (check_cancel())
-		return roman_font;
-	    set_temp_cursor(wait_cursor);
-	    fontst = XLoadQueryFont(tool_d, fn);
+	if ((fc = (struct font_cache *) malloc(sizeof(struct font_cache))) != NULL) {
+	    fc->fnum = fnum;
+	    fc->size = size;
+	    fc->nf = nf;
+	    fc->next = font_hash[h];
+	    font_hash[h] = fc;
+	}
+	return nf;
+}
+
+/* make the XLFD name of the font "xtemplate" (e.g. -*-times-medium-r-normal--) in "size" */
+
+static void
+xfont_name(char *name, char *xtemplate, int size)
+{
+	char		template[300];
+
+	strcpy(template,xtemplate);
+	/* attach pointsize to font name */
+	strcat(template,"%d-*-*-*-*-*-");
+	/* add ISO8859 (if not Symbol font or ZapfDingbats) to font name in non-international mode */
+	if (
 #ifdef I18N
-            /* create fontsets for all fonts but Symbol and Dingbats */
-	    if (appres.international &&
-                strstr(fn,"ymbol") == NULL &&
-		strstr(fn,"ingbats") == NULL)
-		  fontset = XCreateFontSet(tool_d, fn, &mcharset, &ncharset, &defstr);
+	    !appres.international &&
 #endif
-	    reset_cursor();
-	    if (fontst == NULL) {
-		/* doesn't exist, see if substituting "condensed" for "narrow" will match */
-		if ((sub=strstr(fn,"-narrow-")) != NULL) {
-		    strcpy(template, fn);
-		    strcpy(&template[sub-fn],"-condensed-");
-		    strcat(template, (sub+8));
-		    /* try it */
-		    fontst = XLoadQueryFont(tool_d, template);
+	    strstr(template,"ymbol") == NULL &&
+	    strstr(template,"ingbats") == NULL)
+		strcat(template,"ISO8859-*");
+	else
+		strcat(template,"*-*");
+	/* use the pixel field instead of points in the fontname so that the
+	font scales with screen size */
+	sprintf(name, template, size);
+}
+
+/* load the X font of nf, trying the backup name and "condensed" for "narrow" */
+
+static void
+load_xfont(struct xfont *nf)
+{
+	XFontStruct    *fontst;
+	XFontSet        fontset = NULL;
+	char		fn[300];
+	char		template[300], *sub;
+
+	strcpy(fn, nf->fname);
+	if (appres.DEBUG)
+	    fprintf(stderr,"Loading font %s\n",fn);
+	set_temp_cursor(wait_cursor);
+	fontst = XLoadQueryFont(tool_d, fn);
+#ifdef I18N
+	fontset = make_fontset(fn);
+#endif
+	reset_cursor();
+	if (fontst == NULL) {
+	    /* doesn't exist, see if substituting "condensed" for "narrow" will match */
+	    if ((sub=strstr(fn,"-narrow-")) != NULL) {
+		strcpy(template, fn);
+		strcpy(&template[sub-fn],"-condensed-");
+		strcat(template, (sub+8));
+		/* try it */
+		fontst = XLoadQueryFont(tool_d, template);
+	    } else if (nf->bname) {
+		/* doesn't exist, try backup font name */
+		fontst = XLoadQueryFont(tool_d, nf->bname);
+		if (fontst) {
+		    /* use this name instead */
+		    strcpy(nf->fname, nf->bname);
 		} else {
-		    /* doesn't exist, try backup font name */
-		    fontst = XLoadQueryFont(tool_d, nf->bname);
-		    if (fontst) {
-			/* use this name instead */
-			strcpy(nf->fname, nf->bname);
-		    } else {
-			/* backup name doesn't exist, see if we can substitute "condensed" for "narrow" */
-			if ((sub=strstr(nf->bname,"-narrow-")) != NULL) {
-			    /* see if substituting "condensed" for "narrow" will match */
-			    strcpy(template, nf->bname);
-			    strcpy(&template[sub-nf->bname],"-condensed-");
-			    strcat(template, (sub+8));
-			    /* try it */
-			    fontst = XLoadQueryFont(tool_d, template);
-			}
+		    /* backup name doesn't exist, see if we can substitute "condensed" for "narrow" */
+		    if ((sub=strstr(nf->bname,"-narrow-")) != NULL) {
+			/* see if substituting "condensed" for "narrow" will match */
+			strcpy(template, nf->bname);
+			strcpy(&template[sub-nf->bname],"-condensed-");
+			strcat(template, (sub+8));
+			/* try it */
+			fontst = XLoadQueryFont(tool_d, template);
 		    }
 		}
 	    }
-	    if (fontst == NULL) {
-		/* even that font doesn't exist, use a plain one */
-		file_msg("Can't find %s, using %s", fn, appres.normalFont);
-		fontst = XLoadQueryFont(tool_d, appres.normalFont);
-		if (nf->fname)
-		    free(nf->fname);
-		/* allocate space for the name and put it in the structure */
-		nf->fname = (char *) new_string(strlen(appres.normalFont));
-		strcpy(nf->fname, appres.normalFont);  /* keep actual name */
-	    }
+	}
+	if (fontst == NULL) {
+	    /* even that font doesn't exist, use a plain one */
+	    file_msg("Can't find %s, using %s", fn, appres.normalFont);
+	    fontst = XLoadQueryFont(tool_d, appres.normalFont);
+	    if (nf->fname)
+		free(nf->fname);
+	    /* allocate space for the name and put it in the structure */
+	    nf->fname = (char *) new_string(strlen(appres.normalFont));
+	    strcpy(nf->fname, appres.normalFont);  /* keep actual name */
+	}
 
-	    /* put the structure in the list */
-	    nf->fstruct = fontst;
-	    nf->fset = fontset;
-	} /* if (nf->fstruct == NULL) */
+	/* put the structure in the list */
+	nf->fstruct = fontst;
+	nf->fset = fontset;
+}
 
-	return (nf->fstruct);
+#ifdef I18N
+/* create fontsets for all fonts but Symbol and Dingbats */
+
+static XFontSet
+make_fontset(char *fn)
+{
+	char **mcharset;
+	int ncharset;
+	char *defstr;
+
+	if (appres.international &&
+	    strstr(fn,"ymbol") == NULL &&
+	    strstr(fn,"ingbats") == NULL)
+		return XCreateFontSet(tool_d, fn, &mcharset, &ncharset, &defstr);
+	return NULL;
 }
+#endif
 
 /* print "string" in window "w" using font specified in fstruct at angle
 	"angle" (radians) at (x,y)
@@ -503,7 +741,8 @@ textsize(XFontStruct *fstruct, int n, char *s)
 static int	gc_thickness[NUMOPS],
 		gc_line_style[NUMOPS],
 		gc_join_style[NUMOPS],
-		gc_cap_style[NUMOPS];
+		gc_cap_style[NUMOPS],
+		gc_ndash[NUMOPS];
 
 GC
 makegc(int op, Pixel fg, Pixel bg)
@@ -565,6 +804,8 @@ void init_gc(void)
 	gc_thickness[i] = -1;
 	gc_line_style[i] = -1;
 	gc_join_style[i] = -1;
+	gc_cap_style[i] = -1;
+	gc_ndash[i] = 0;
     }
     /* gc for page border and axis lines */
     border_gc = DefaultGC(tool_d, tool_sn);
@@ -582,6 +823,15 @@ void init_gc(void)
 
 }
 
+/* what was last sent to the server for each fill_gc[], see set_fill_gc() */
+
+static struct {
+    Pixel	    fg, bg;
+    Pixmap	    stipple;
+    int		    xorg, yorg;
+    unsigned long   clip_gen;
+} fill_gc_state[NUMFILLPATS];
+
 /* create the gc's for fill style (PAINT and ERASE) */
 /* the fill_pm[] must already be created */
 
@@ -603,6 +853,11 @@ void init_fill_gc(void)
 	    mask |= GCStipple;
 	}
 	XChangeGC(tool_d, fill_gc[i], mask, &gcv);
+	fill_gc_state[i].fg = x_fg_color.pixel;
+	fill_gc_state[i].bg = x_color(BLACK);
+	fill_gc_state[i].stipple = fill_pm[i];
+	fill_gc_state[i].xorg = fill_gc_state[i].yorg = 0;
+	fill_gc_state[i].clip_gen = 0;
     }
 }
 
@@ -1025,12 +1280,12 @@ void init_fill_pm(void)
 	rescale_pattern(i);
 	j = i-(NUMSHADEPATS+NUMTINTPATS);
 	/* save these patterns at zoom = 1 for the fill button panel */
-	fill_but_pm[j] = fill_pm[i];
+	/* (a copy of its own, the canvas one belongs to the pattern cache) */
+	fill_but_pm[j] = XCreateBitmapFromData(tool_d, tool_w,
+				   pattern_images[j].cdata,
+				   pattern_images[j].cwidth,
+				   pattern_images[j].cheight);
 	fill_but_pm_zoom[j] = fill_pm_zoom[i];
-	/* to force new pixmaps for canvas */
-	fill_pm[i] = (Pixmap) 0;
-	/* and create another one */
-	rescale_pattern(i);
 	/* create fill style pixmaps for indicator button */
 	/* The actual colors of fg/bg will be reset in recolor_fillstyles */
 	fillstyle_choices[i + 1].pixmap = XCreatePixmapFromBitmapData(tool_d,
@@ -1247,6 +1502,7 @@ void set_clip_window(int xmin, int ymin, int xmax, int ymax)
     clip_ymax = ymax;
     clip_width = clip[0].width = xmax - xmin + 1;
     clip_height = clip[0].height = ymax - ymin + 1;
+    clip_gen++;
     XSetClipRectangles(tool_d, border_gc, 0, 0, clip, 1, YXBanded);
     XSetClipRectangles(tool_d, gccache[PAINT], 0, 0, clip, 1, YXBanded);
     XSetClipRectangles(tool_d, gccache[INV_PAINT], 0, 0, clip, 1, YXBanded);
@@ -1266,6 +1522,8 @@ void reset_clip_window(void)
 void set_fill_gc(int fill_style, int op, int pencolor, int fillcolor, int xorg, int yorg)
 {
     Color	    fg, bg;
+    XGCValues	    gcv;
+    unsigned long   mask;
 
     /* see if we need to create this fill style if it is a pattern.
        This might have happened if there was a change of zoom. */
@@ -1295,13 +1553,37 @@ void set_fill_gc(int fill_style, int op, int pencolor, int fillcolor, int xorg,
 	fg = x_bg_color.pixel;   /* un-fill */
 	bg = x_bg_color.pixel;
     }
-    XSetForeground(tool_d,fillgc,fg);
-    XSetBackground(tool_d,fillgc,bg);
+
+    /* only send the server what is different from the last time */
+    mask = 0;
+    if (fg != fill_gc_state[fill_style].fg) {
+	gcv.foreground = fill_gc_state[fill_style].fg = fg;
+	mask |= GCForeground;
+    }
+    if (bg != fill_gc_state[fill_style].bg) {
+	gcv.background = fill_gc_state[fill_style].bg = bg;
+	mask |= GCBackground;
+    }
     /* set stipple from the fill_pm array */
-    XSetStipple(tool_d, fillgc, fill_pm[fill_style]);
+    if (fill_pm[fill_style] != fill_gc_state[fill_style].stipple) {
+	gcv.stipple = fill_gc_state[fill_style].stipple = fill_pm[fill_style];
+	mask |= GCStipple;
+    }
     /* set origin of pattern relative to object itself */
-    XSetTSOrigin(tool_d, fillgc, ZOOMX(xorg), ZOOMY(yorg));
-    XSetClipRectangles(tool_d, fillgc, 0, 0, clip, 1, YXBanded);
+    gcv.ts_x_origin = ZOOMX(xorg);
+    gcv.ts_y_origin = ZOOMY(yorg);
+    if (gcv.ts_x_origin != fill_gc_state[fill_style].xorg ||
+	gcv.ts_y_origin != fill_gc_state[fill_style].yorg) {
+	    fill_gc_state[fill_style].xorg = gcv.ts_x_origin;
+	    fill_gc_state[fill_style].yorg = gcv.ts_y_origin;
+	    mask |= GCTileStipXOrigin | GCTileStipYOrigin;
+    }
+    if (mask)
+	XChangeGC(tool_d, fillgc, mask, &gcv);
+    if (fill_gc_state[fill_style].clip_gen != clip_gen) {
+	XSetClipRectangles(tool_d, fillgc, 0, 0, clip, 1, YXBanded);
+	fill_gc_state[fill_style].clip_gen = clip_gen;
+    }
 }
 
 
@@ -1338,6 +1620,8 @@ void set_line_stuff(int width, int style, float style_val, int join_style, int c
 {
     XGCValues	    gcv;
     unsigned long   mask;
+    unsigned char   dashes[8];
+    int		    il, nd;
 
     switch (style) {
       case RUBBER_LINE:
@@ -1359,55 +1643,27 @@ void set_line_stuff(int width, int style, float style_val, int join_style, int c
     if (width == 0 && style != SOLID_LINE)
 	width = 1;
 
-    /* see if all gc stuff is already correct */
-
-    if (width == gc_thickness[op] && style == gc_line_style[op] &&
-	join_style == gc_join_style[op] &&
-	cap_style == gc_cap_style[op] &&
-	(x_color(color) == gc_color[op]) &&
-	((style != DASH_LINE && style != DOTTED_LINE &&
-          style != DASH_DOT_LINE && style != DASH_2_DOTS_LINE &&
-          style != DASH_3_DOTS_LINE) ||
-	 dash_list[op][1] == (unsigned char) round(style_val * display_zoomscale)))
-	    return;			/* no need to change anything */
-
-    gcv.line_width = width;
-    mask = GCLineWidth | GCLineStyle | GCCapStyle | GCJoinStyle;
-    if (op == PAINT) {
-	gcv.foreground = x_color(color);
-	mask |= GCForeground;
-    } else if (op == INV_PAINT) {
-	gcv.foreground = x_color(color) ^ x_bg_color.pixel;
-	mask |= GCForeground;
-    }
-    gcv.join_style = join_styles[join_style];
-    gcv.cap_style = cap_styles[cap_style];
-    gcv.line_style = (style == DASH_LINE || style == DOTTED_LINE ||
-             style == DASH_DOT_LINE || style == DASH_2_DOTS_LINE ||
-             style == DASH_3_DOTS_LINE) ?
-	LineOnOffDash : LineSolid;
-
-    XChangeGC(tool_d, gccache[op], mask, &gcv);
+    /* work out the dashes first so we can see if they changed */
+    nd = 0;
     if (style_val > 0.0) {	/* style_val of 0.0 causes problems */
 	if (style == DASH_LINE || style == DOTTED_LINE) {
+	    nd = 2;
 	    /* length of ON/OFF pixels */
 	    if (style_val * display_zoomscale > 255.0)
-		dash_list[op][0] = dash_list[op][1] = (char) 255;	/* too large for X! */
+		dashes[0] = dashes[1] = (char) 255;	/* too large for X! */
 	    else
-	        dash_list[op][0] = dash_list[op][1] =
+	        dashes[0] = dashes[1] =
 				(char) round(style_val * display_zoomscale);
 	    /* length of ON pixels for dotted */
 	    if (style == DOTTED_LINE)
-		dash_list[op][0] = (char)display_zoomscale;
+		dashes[0] = (char)display_zoomscale;
 
-	    if (dash_list[op][0]==0)		/* take care for rounding to zero ! */
-		dash_list[op][0]=1;
-	    if (dash_list[op][1]==0)		/* take care for rounding to zero ! */
-		dash_list[op][1]=1;
-	    XSetDashes(tool_d, gccache[op], 0, (char *) dash_list[op], 2);
+	    if (dashes[0]==0)		/* take care for rounding to zero ! */
+		dashes[0]=1;
+	    if (dashes[1]==0)		/* take care for rounding to zero ! */
+		dashes[1]=1;
 	} else if (style == DASH_DOT_LINE || style == DASH_2_DOTS_LINE ||
 		  style == DASH_3_DOTS_LINE) {
-            int il, nd;
             float *fl;
             if (style == DASH_2_DOTS_LINE) {
 		fl=dash_2dots;
@@ -1422,19 +1678,57 @@ void set_line_stuff(int width, int style, float style_val, int join_style, int c
 	    for (il =0; il<nd; il ++) {
                 if (fl[il] != 0.) {
 		    if (fl[il] * style_val * display_zoomscale > 255.0)
-			dash_list[op][il] = (char) 255;	/* too large for X! */
+			dashes[il] = (char) 255;	/* too large for X! */
 		    else
-			dash_list[op][il] = (char) round(fl[il] * style_val *
+			dashes[il] = (char) round(fl[il] * style_val *
 					display_zoomscale);
 		} else {
-		    dash_list[op][il] = (char)display_zoomscale;
+		    dashes[il] = (char)display_zoomscale;
 		}
-		if (dash_list[op][il]==0)	/* take care for rounding to zero ! */
-			dash_list[op][il]=1;
+		if (dashes[il]==0)	/* take care for rounding to zero ! */
+			dashes[il]=1;
 	    }
-	    XSetDashes(tool_d, gccache[op], 0, (char *) dash_list[op], nd);
 	}
     }
+
+    /* only change the parts of the gc that aren't already correct */
+    mask = 0;
+    if (width != gc_thickness[op]) {
+	gcv.line_width = width;
+	mask |= GCLineWidth;
+    }
+    if (style != gc_line_style[op]) {
+	gcv.line_style = (style == DASH_LINE || style == DOTTED_LINE ||
+             style == DASH_DOT_LINE || style == DASH_2_DOTS_LINE ||
+             style == DASH_3_DOTS_LINE) ?
+	    LineOnOffDash : LineSolid;
+	mask |= GCLineStyle;
+    }
+    if (join_style != gc_join_style[op]) {
+	gcv.join_style = join_styles[join_style];
+	mask |= GCJoinStyle;
+    }
+    if (cap_style != gc_cap_style[op]) {
+	gcv.cap_style = cap_styles[cap_style];
+	mask |= GCCapStyle;
+    }
+    if (x_color(color) != gc_color[op]) {
+	if (op == PAINT) {
+	    gcv.foreground = x_color(color);
+	    mask |= GCForeground;
+	} else if (op == INV_PAINT) {
+	    gcv.foreground = x_color(color) ^ x_bg_color.pixel;
+	    mask |= GCForeground;
+	}
+    }
+    if (mask)
+	XChangeGC(tool_d, gccache[op], mask, &gcv);
+    /* a solid line leaves the old dashes in the gc, they don't matter */
+    if (nd > 0 && (nd != gc_ndash[op] || memcmp(dashes, dash_list[op], nd) != 0)) {
+	memcpy(dash_list[op], dashes, nd);
+	gc_ndash[op] = nd;
+	XSetDashes(tool_d, gccache[op], 0, (char *) dash_list[op], nd);
+    }
     gc_thickness[op] = width;
     gc_line_style[op] = style;
     gc_join_style[op] = join_style;
@@ -1477,35 +1771,71 @@ x_color(int col)
 	return pix;
 }
 
+/*
+ * The scaled pattern pixmaps are kept for the last few sizes each pattern
+ * was drawn at, so zooming back and forth doesn't scale them again.
+ * The size depends only on display_zoomscale, and so does the scaled
+ * bitmap, so the size is the key.
+ */
+
+#define PAT_CACHE_SIZE	4
+
+static struct {
+    Pixmap	    pm;
+    int		    width, height;
+    unsigned long   used;		/* for dropping the least recently used */
+} pat_cache[NUMPATTERNS][PAT_CACHE_SIZE];
+static unsigned long pat_cache_clock = 0;
+
 /* resize the fill patterns for the current display_zoomscale */
 /* also generate new Pixmaps in fill_pm[] */
 
 void rescale_pattern(int patnum)
 {
-	int		j;
-	XGCValues	gcv;
+	int		i, j, k;
+	int		width, height;
 
-	/* this make a few seconds (depending on the machine) */
-	set_temp_cursor(wait_cursor);
 	j = patnum-(NUMSHADEPATS+NUMTINTPATS);
-	/* first rescale the data */
-	scale_pattern(j);
-	/* free any old pixmaps before creating new ones */
-	if (fill_pm[patnum]) {
-		XFreePixmap(tool_d,fill_pm[patnum]);
+	/* same size as scale_pattern() will make */
+	width = display_zoomscale * pattern_images[j].owidth;
+	height = display_zoomscale * pattern_images[j].oheight;
+	if (width == 0)
+	    width = 1;
+	if (height == 0)
+	    height = 1;
+
+	/* look for it in the cache, else take the oldest (or empty) slot */
+	k = 0;
+	for (i = 0; i < PAT_CACHE_SIZE; i++) {
+	    if (pat_cache[j][i].pm && pat_cache[j][i].width == width &&
+		pat_cache[j][i].height == height)
+		    break;
+	    if (pat_cache[j][i].used < pat_cache[j][k].used)
+		k = i;
 	}
-	fill_pm[patnum] = XCreateBitmapFromData(tool_d, tool_w,
+	if (i < PAT_CACHE_SIZE) {
+	    k = i;
+	} else {
+	    /* this make a few seconds (depending on the machine) */
+	    set_temp_cursor(wait_cursor);
+	    /* first rescale the data */
+	    scale_pattern(j);
+	    /* free the pixmap we are replacing */
+	    if (pat_cache[j][k].pm)
+		XFreePixmap(tool_d, pat_cache[j][k].pm);
+	    pat_cache[j][k].pm = XCreateBitmapFromData(tool_d, tool_w,
 				   pattern_images[j].cdata,
 				   pattern_images[j].cwidth,
 				   pattern_images[j].cheight);
+	    pat_cache[j][k].width = width;
+	    pat_cache[j][k].height = height;
+	    reset_cursor();
+	}
+	pat_cache[j][k].used = ++pat_cache_clock;
+	fill_pm[patnum] = pat_cache[j][k].pm;
 	/* set the zoom value so we know what zoom it was generated for */
+	/* (set_fill_gc() puts the new pixmap in the gc) */
 	fill_pm_zoom[patnum] = display_zoomscale;
-	/* now update the gc to use the new pixmaps */
-	if (fill_gc[patnum]) {
-	    gcv.stipple = fill_pm[patnum];
-	    XChangeGC(tool_d, fill_gc[patnum], GCStipple, &gcv);
-	}
-	reset_cursor();
 }
 
 void scale_pattern(int indx)
@@ -95,6 +95,8 @@ extern XFontStruct *roman_font;
 extern XFontStruct *button_font;
 extern XFontStruct *canvas_font;
 extern XFontStruct *lookfont(int fnum, int size);
+extern int	    zoomed_font_size(int size);
+extern void	    load_xfonts(int n, int *fonts, int *sizes);
 extern GC	    makegc(int op, Pixel fg, Pixel bg);
 
 /* patterns like bricks, etc */
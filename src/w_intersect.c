@@ -1108,13 +1108,14 @@ intersect_ellipse_arc_handler(F_ellipse * e, F_arc * a, int x, int y, isect_cb_s
   }
 }
 
-void
-intersect_polyline_polyline_handler(F_line * l1, F_line * l2, int x, int y, isect_cb_s * isect_cb)
+/* test one pair of segments: p1a-p1b of the first polyline and		*/
+/* segment seg_idx, p2a-p2b, of the second					*/
+
+static void
+isect_segments(struct f_point * p1a, struct f_point * p1b,
+	       struct f_point * p2a, struct f_point * p2b, int seg_idx,
+	       int x, int y, isect_cb_s * isect_cb, double * mind)
 {
-  struct f_point * p1;
-  struct f_point * p2;
-  struct f_point * p1_start;
-  struct f_point * p2_start;
   double c1[3];
   double c2[3];
 #define lA c1[0]
@@ -1131,51 +1132,143 @@ intersect_polyline_polyline_handler(F_line * l1, F_line * l2, int x, int y, isec
   double det;
   double ix, iy;
   double dist;
+
+  if (False == boxes_overlap(p1a, p1b, p2a, p2b))
+    return;
+  get_line_from_points(c1, p1a, p1b);
+  get_line_from_points(c2, p2a, p2b);
+  det = (lB * lD) - (lA * lE);
+  ciA = lE/det;
+  ciB = -lD/det;
+  ciC = -lB/det;
+  ciD = lA/det;
+  ix = (lC * ciA) + (lF * ciC);
+  iy = (lC * ciB) + (lF * ciD);
+  snap_found = True;
+  if (isect_cb) {
+    if ((True == is_point_on_segment((double)(p1a->x), (double)(p1a->y),
+				     ix, iy,
+				     (double)(p1b->x), (double)(p1b->y))) &&
+	(True == is_point_on_segment((double)(p2a->x), (double)(p2a->y),
+				     ix, iy,
+				     (double)(p2b->x), (double)(p2b->y))))
+      insert_isect(isect_cb, ix, iy, seg_idx);
+  }
+  else {
+    dist = hypot(iy - (double)y, ix - (double)x);
+    if (dist < *mind) {
+      *mind = dist;
+      snap_gx = (int)rint(ix);
+      snap_gy = (int)rint(iy);
+    }
+  }
+}
+
+/* the segments of a polyline, for the sweep in x			*/
+
+typedef struct {
+  struct f_point * a;
+  struct f_point * b;
+  int xmin, xmax;
+  int seg_idx;
+} sweep_seg_s;
+
+/* below this many segment pairs, just test every pair			*/
+#define SWEEP_MIN_PAIRS 64
+
+static int
+sweep_seg_fcn(const void * a, const void * b)
+{
+  const sweep_seg_s * sa = a;
+  const sweep_seg_s * sb = b;
+
+  return (sa->xmin < sb->xmin) ? -1 : ((sa->xmin > sb->xmin) ? 1 : 0);
+}
+
+/* fill segs with the segments of l sorted on their left end; returns	*/
+/* their number								*/
+
+static int
+sweep_segments(F_line * l, sweep_seg_s * segs)
+{
+  struct f_point * p;
+  struct f_point * p_start;
+  int n;
+
+  for (n = 0, p_start = l->points, p = p_start->next; p != NULL;
+       p_start = p, p = p->next, n++) {
+    segs[n].a = p_start;
+    segs[n].b = p;
+    segs[n].xmin = min2(p_start->x, p->x);
+    segs[n].xmax = max2(p_start->x, p->x);
+    segs[n].seg_idx = n;
+  }
+  qsort(segs, n, sizeof(sweep_seg_s), sweep_seg_fcn);
+  return n;
+}
+
+void
+intersect_polyline_polyline_handler(F_line * l1, F_line * l2, int x, int y, isect_cb_s * isect_cb)
+{
+  struct f_point * p1;
+  struct f_point * p2;
+  struct f_point * p1_start;
+  struct f_point * p2_start;
+  sweep_seg_s * segs1;
+  sweep_seg_s * segs2;
+  int n1, n2;
+  int i, j, k;
   double mind;
   int seg_idx;
 
   mind = HUGE_VAL;
-  p1_start = NULL;
-  for (p1 = l1->points; p1 != NULL; p1 = p1->next) {
-    if (p1_start) {
-      get_line_from_points(c1, p1_start, p1);
-      p2_start = NULL;
-      for (seg_idx = -1, p2 = l2->points; p2 != NULL; seg_idx++, p2 = p2->next) {
-	if (p2_start) {
-	  if (True == boxes_overlap(p1_start, p1, p2_start, p2)) {
-	    get_line_from_points(c2, p2_start, p2);
-	    det = (lB * lD) - (lA * lE);
-	    ciA = lE/det;
-	    ciB = -lD/det;
-	    ciC = -lB/det;
-	    ciD = lA/det;
-	    ix = (lC * ciA) + (lF * ciC);
-	    iy = (lC * ciB) + (lF * ciD);
-	    snap_found = True;
-	    if (isect_cb) {
-	      if ((True == is_point_on_segment((double)(p1_start->x), (double)(p1_start->y),
-					       ix, iy,
-					       (double)(p1->x), (double)(p1->y))) &&
-		  (True == is_point_on_segment((double)(p2_start->x), (double)(p2_start->y),
-					       ix, iy,
-					       (double)(p2->x), (double)(p2->y))))
-		insert_isect(isect_cb, ix, iy, seg_idx);
-	    }
-	    else {
-	      dist = hypot(iy - (double)y, ix - (double)x);
-	      if (dist < mind) {
-		mind = dist;
-		snap_gx = (int)rint(ix);
-		snap_gy = (int)rint(iy);
-	      }
-	    }
-	  }
+  for (n1 = 0, p1 = l1->points; p1 != NULL; p1 = p1->next, n1++);
+  for (n2 = 0, p2 = l2->points; p2 != NULL; p2 = p2->next, n2++);
+  segs1 = segs2 = NULL;
+  if ((n1 - 1) * (n2 - 1) > SWEEP_MIN_PAIRS) {
+    segs1 = malloc(n1 * sizeof(sweep_seg_s));
+    segs2 = malloc(n2 * sizeof(sweep_seg_s));
+  }
+
+  if (segs1 && segs2) {
+    /* sweep a line across x: take the segments in order of their left	*/
+    /* end and test each only against the segments of the other		*/
+    /* polyline that start before it ends				*/
+    n1 = sweep_segments(l1, segs1);
+    n2 = sweep_segments(l2, segs2);
+    for (i = j = 0; i < n1 && j < n2; ) {
+      if (segs1[i].xmin <= segs2[j].xmin) {
+	for (k = j; k < n2 && segs2[k].xmin <= segs1[i].xmax; k++)
+	  isect_segments(segs1[i].a, segs1[i].b, segs2[k].a, segs2[k].b,
+			 segs2[k].seg_idx, x, y, isect_cb, &mind);
+	i++;
+      }
+      else {
+	for (k = i; k < n1 && segs1[k].xmin <= segs2[j].xmax; k++)
+	  isect_segments(segs1[k].a, segs1[k].b, segs2[j].a, segs2[j].b,
+			 segs2[j].seg_idx, x, y, isect_cb, &mind);
+	j++;
+      }
+    }
+  }
+  else {
+    p1_start = NULL;
+    for (p1 = l1->points; p1 != NULL; p1 = p1->next) {
+      if (p1_start) {
+	p2_start = NULL;
+	for (seg_idx = -1, p2 = l2->points; p2 != NULL; seg_idx++, p2 = p2->next) {
+	  if (p2_start)
+	    isect_segments(p1_start, p1, p2_start, p2, seg_idx,
+			   x, y, isect_cb, &mind);
+	  p2_start = p2;
 	}
-	p2_start = p2;
       }
+      p1_start = p1;
     }
-    p1_start = p1;
   }
+  free(segs1);
+  free(segs2);
+
   if (!isect_cb) {
     if (False == snap_found) {
       put_msg("Selected polylines do not intersect.");
@@ -24,6 +24,8 @@
 #include "mode.h"
 #include "e_placelib.h"
 #include "e_placelib.h"
+#include "f_libindex.h"
+#include "f_libsearch.h"
 #include "f_read.h"
 #include "u_create.h"
 #include "u_redraw.h"
@@ -74,6 +76,17 @@ static void	sel_view(Widget w, XtPointer new_view, XtPointer garbage), change_ic
 static void	set_preview_name(int obj), update_preview(void);
 static Boolean	preview_libobj(int objnum, Pixmap pixmap, int pixsize, int margin);
 static void	copy_icon_to_preview(int object);
+static unsigned char *icon_to_thumb(Pixmap icon, long *len);
+static Boolean	thumb_to_icon(unsigned char *thumb, long len, Pixmap icon);
+static Boolean	make_lib_icons(XtPointer client_data);
+static int	next_lib_icon(void);
+static void	end_lib_icons(void), pause_lib_icons(void), resume_lib_icons(void);
+static void	show_obj_comments(int obj);
+static void	search_library(Widget w, XEvent *ev);
+static void	popup_search_results(int nhits);
+static void	search_result_sel(Widget w, XtPointer closure, XtPointer call_data);
+static void	search_close(Widget w, XtPointer closure, XtPointer call_data);
+static void	search_close_action(Widget w, XEvent *ev, String *params, Cardinal *nparams);
 
 DeclareStaticArgs(15);
 
@@ -93,10 +106,31 @@ static Widget	library_status;
 static Widget	lib_preview_label, preview_lib_widget;
 static Widget	comment_label, object_comments;
 static Widget	cancel, selobj, stop;
+static Widget	search_text;
+static Widget	search_popup=0, search_label, search_list;
 static Widget	lib_buttons[N_LIB_OBJECT_MAX];
 
 static Pixmap	preview_lib_pixmap, cur_obj_preview;
 static Pixmap	lib_icons[N_LIB_OBJECT_MAX];
+static char	*lib_comments[N_LIB_OBJECT_MAX];	/* comments of objects whose icon came from the index */
+static Boolean	icon_pending[N_LIB_OBJECT_MAX];	/* icon not drawn yet */
+static int	num_icons_pending = 0;
+static int	first_pending = 0;		/* no icon before this one is pending */
+/* where the buttons are in icon_box, kept while its width stays geom_box_wd */
+static struct {
+    Position	    x, y;
+    Dimension	    w, h;
+}		icon_geom[N_LIB_OBJECT_MAX];
+static Dimension geom_box_wd = 0;		/* 0 if icon_geom must be made again */
+/* the buttons seen in the viewport at scroll position vis_bx, vis_by */
+static Boolean	vis_valid = False;
+static Position	vis_bx, vis_by;
+static Dimension vis_vw, vis_vh;
+static int	vis_lo, vis_hi, vis_next;
+static XtWorkProcId icon_work = (XtWorkProcId) 0;	/* draws the pending icons */
+static struct lib_index *lib_index = NULL;	/* index read for the current library */
+static struct lib_index *lib_newindex = NULL;	/* and the one being made for it */
+static Boolean	lib_index_changed = False;
 static Pixel	sel_color, unsel_color;
 static int	num_library_names;
 static int	num_list_items=0;
@@ -107,6 +141,8 @@ static char	*icon_sizes[] = { "40", "60", "80", "100", "120" };
 static int	num_icon_sizes = sizeof(icon_sizes)/sizeof(char *);
 static Boolean	loading_library = False;	/* lockout flag */
 static Boolean	library_stop_request = False;	/* to stop loading library */
+static struct libsearch_obj **search_hits;
+static char	**search_texts = NULL;		/* "object (library)" for the result list */
 
 static String	library_translations =
 			"<Message>WM_PROTOCOLS: DismissLibrary()\n\
@@ -121,6 +157,10 @@ static String	object_icon_translations =
 	"<Btn1Down>,<Btn1Up>: sel_item_icon()\n\
 	 <Btn1Up>(2): put_object_sel()\n\
 	 <Key>Return: put_object_sel()\n";
+static String	search_text_translations =
+	"<Key>Return: search_library()\n\
+	 Ctrl<Key>J: search_library()\n\
+	 Ctrl<Key>M: search_library()\n";
 
 static XtActionsRec	library_actions[] =
 {
@@ -129,6 +169,8 @@ static XtActionsRec	library_actions[] =
   {"load_library",	(XtActionProc) load_library},
   {"sel_item_icon",	(XtActionProc) sel_item_icon},
   {"put_object_sel",	(XtActionProc) put_object_sel},
+  {"search_library",	(XtActionProc) search_library},
+  {"CloseLibrarySearch",	(XtActionProc) search_close_action},
 };
 
 struct lib_rec {
@@ -164,6 +206,7 @@ static Boolean	PutLibraryEntry(struct lib_rec *librec, char *path, char *lname,
 static Boolean	lib_just_loaded, icons_made;
 static Boolean	load_lib_obj(int obj);
 static Widget	make_library_menu(Widget parent, char *name, struct lib_rec **librec, int num);
+static int	scan_search_libs(struct lib_rec **librec, int num);
 
 
 static int
@@ -208,6 +251,9 @@ library_stop(Widget w, XButtonEvent *ev)
 static void
 library_dismiss(void)
 {
+  pause_lib_icons();
+  if (search_popup)
+    XtPopdown(search_popup);
   XtPopdown(library_popup);
   put_selected_request();
 }
@@ -248,6 +294,9 @@ library_cancel(Widget w, XButtonEvent *ev)
     }
 
     /* get rid of the popup */
+    pause_lib_icons();
+    if (search_popup)
+	XtPopdown(search_popup);
     XtPopdown(library_popup);
 
     /* if user was in the library mode when he popped this up AND there is a
@@ -518,6 +567,8 @@ popup_library_panel(void)
 
     old_library_object = cur_library_object;
     XtPopup(library_popup, XtGrabNonexclusive);
+    /* go on drawing any icons that weren't finished */
+    resume_lib_icons();
 
     /* raise the window of the (form of the) view we want */
     if (appres.icon_view) {
@@ -696,6 +747,37 @@ create_library_panel(void)
     XtAddEventHandler(stop, ButtonReleaseMask, False,
 		    (XtEventHandler) library_stop, (XtPointer) NULL);
 
+    /* text to search all the libraries for objects */
+
+    FirstArg(XtNlabel, "Search:");
+    NextArg(XtNfromVert, status_label);
+    NextArg(XtNfromHoriz, stop);
+    NextArg(XtNhorizDistance, 10);
+    NextArg(XtNborderWidth, 0);
+    NextArg(XtNtop, XtChainTop);
+    NextArg(XtNbottom, XtChainTop);
+    NextArg(XtNleft, XtChainLeft);
+    NextArg(XtNright, XtChainLeft);
+    beside = XtCreateManagedWidget("search_label", labelWidgetClass,
+				 library_form, Args, ArgCount);
+
+    FirstArg(XtNeditType, XawtextEdit);
+    NextArg(XtNstring, "");
+    NextArg(XtNleftMargin, 4);
+    NextArg(XtNwidth, 200);
+    NextArg(XtNfromVert, status_label);
+    NextArg(XtNfromHoriz, beside);
+    NextArg(XtNborderWidth, INTERNAL_BW);
+    NextArg(XtNscrollHorizontal, XawtextScrollWhenNeeded);
+    NextArg(XtNtop, XtChainTop);
+    NextArg(XtNbottom, XtChainTop);
+    NextArg(XtNleft, XtChainLeft);
+    NextArg(XtNright, XtChainRight);
+    search_text = XtCreateManagedWidget("search_text", asciiTextWidgetClass,
+				 library_form, Args, ArgCount);
+    XtOverrideTranslations(search_text,
+			XtParseTranslationTable(search_text_translations));
+
     FirstArg(XtNlabel,"Selected object:");
     NextArg(XtNresize, False);
     NextArg(XtNfromVert, stop);
@@ -1107,6 +1189,7 @@ sel_view(Widget w, XtPointer new_view, XtPointer garbage)
 	return;
 
     appres.icon_view = (int) new_view;
+    geom_box_wd = 0;
 
     /* change the label in the menu button */
     FirstArg(XtNlabel, viewtypes[(int) appres.icon_view]);
@@ -1416,10 +1499,15 @@ MakeObjectLibrary(char *library_dir, char **objects_names, F_libobject **libobje
     int		itm, j;
     int		num_old_items;
     Boolean	flag, status;
+    struct lib_index_entry *entry;
+    struct stat	 st;
+    char	 key[80], fname[PATH_MAX];
 
     flag = True;
     /* we don't yet have the new icons */
     icons_made = False;
+    /* and stop drawing the icons of any previous library */
+    end_lib_icons();
 
     itm = 0;
     num_old_items = num_list_items;
@@ -1459,13 +1547,19 @@ MakeObjectLibrary(char *library_dir, char **objects_names, F_libobject **libobje
         /* save current library name */
         cur_library_path = library_dir;
         cur_objects_names = objects_names;
-	if (appres.icon_view) {
-	    /* disable library and icon size menu buttons so user can't
-	       change them while we're building pixmaps */
-	    FirstArg(XtNsensitive, False);
-	    SetValues(library_menu_button);
-	    SetValues(icon_size_button);
+	/* the icons in the library index are pixel values, so they
+	   can only be used on the same kind of display */
+	if (DIRECT_PIXELS) {
+	    sprintf(key, "%d-%d-%lx-%lx-%lx-%lx", appres.library_icon_size, tool_dpth,
+			tool_v->red_mask, tool_v->green_mask, tool_v->blue_mask,
+			x_bg_color.pixel);
+	    lib_index = read_lib_index(library_dir, key);
+	    lib_newindex = new_lib_index(library_dir, key);
 	}
+	num_icons_pending = 0;
+	first_pending = 0;
+	geom_box_wd = 0;
+	vis_valid = False;
         itm = 0;
         while ((objects_names[itm]!=NULL) && (flag==True)) {
 	    /* free any previous compound objects */
@@ -1473,18 +1567,43 @@ MakeObjectLibrary(char *library_dir, char **objects_names, F_libobject **libobje
 		free_compound(&libobjects[itm]->compound);
 	    }
 	    libobjects[itm]->compound = (F_compound *) 0;
+	    if (lib_comments[itm]) {
+		free(lib_comments[itm]);
+		lib_comments[itm] = (char *) NULL;
+	    }
 	    /* make a new pixmap if one doesn't exist */
 	    if (!lib_icons[itm])
 		lib_icons[itm] = XCreatePixmap(tool_d, canvas_win,
 					appres.library_icon_size, appres.library_icon_size,
 					tool_dpth);
-	    /* preview the object into this pixmap */
-	    status = preview_libobj(itm, lib_icons[itm], appres.library_icon_size, 4);
+	    entry = (struct lib_index_entry *) NULL;
+	    if (lib_index) {
+		sprintf(fname, "%s/%s.fig", library_dir, objects_names[itm]);
+		if (stat(fname, &st) == 0)
+		    entry = find_lib_index_entry(lib_index, objects_names[itm], &st);
+	    }
+	    if (entry && thumb_to_icon(entry->thumb, entry->thumblen, lib_icons[itm])) {
+		/* the object hasn't changed since its icon was put in the index;
+		   it is only read when it is previewed or placed */
+		status = True;
+		icon_pending[itm] = False;
+		lib_comments[itm] = strdup(entry->comments);
+		if (lib_newindex)
+		    add_lib_index_entry(lib_newindex, entry->name, &st, entry->comments,
+				entry->thumb, entry->thumblen);
+	    } else {
+		/* the icon is drawn later by make_lib_icons(), leave it blank for now */
+		status = False;
+		icon_pending[itm] = True;
+		num_icons_pending++;
+		XFillRectangle(tool_d, lib_icons[itm], gccache[ERASE], 0, 0,
+			appres.library_icon_size, appres.library_icon_size);
+	    }
 	    /* finally, make the "button" */
 	    if (!lib_buttons[itm]) {
 		FirstArg(XtNborderWidth, 1);
 		NextArg(XtNborderColor, unsel_color); /* border color same as box bg */
-		NextArg(XtNbitmap, status? lib_icons[itm]: (Pixmap) 0);
+		NextArg(XtNbitmap, lib_icons[itm]);
 		NextArg(XtNinternalHeight, 0);
 		NextArg(XtNinternalWidth, 0);
 		lib_buttons[itm]=XtCreateManagedWidget(objects_names[itm], labelWidgetClass,
@@ -1496,25 +1615,18 @@ MakeObjectLibrary(char *library_dir, char **objects_names, F_libobject **libobje
 				XtParseTranslationTable(object_icon_translations));
 	    } else {
 		/* button exists from previous load, set the pixmap and manage it */
-		FirstArg(XtNbitmap, status? lib_icons[itm]: (Pixmap) 0);
+		FirstArg(XtNbitmap, lib_icons[itm]);
 		SetValues(lib_buttons[itm]);
 		if (status)
 		    XtAugmentTranslations(lib_buttons[itm],
 				XtParseTranslationTable(object_icon_translations));
 		XtManageChild(lib_buttons[itm]);
 	    }
-	    /* let the user see it right away */
-	    process_pending();
 	    itm++;
-	    /* if user has requested to stop loading */
-	    if (library_stop_request) {
-		/* make stop button insensitive */
-	        XtSetSensitive(stop, False);
-		break;
-	    }
         }
 	if (appres.icon_view) {
-	    /* now we have the icons (used in sel_view) */
+	    /* now we have the icons (used in sel_view), even if
+	       some of them are still being drawn */
 	    icons_made = True;
 	}
 	/* destroy any old buttons not being used and their pixmaps */
@@ -1526,16 +1638,16 @@ MakeObjectLibrary(char *library_dir, char **objects_names, F_libobject **libobje
 	    lib_buttons[j] = (Widget) 0;
 	    lib_icons[j] = (Pixmap) 0;
 	}
-	/* re-enable menu buttons (we don't check for appres.icon_view because
-	   the user may have switched to list view while we were building the pixmaps */
-	FirstArg(XtNsensitive, True);
-	SetValues(library_menu_button);
-	SetValues(icon_size_button);
 
-	if (library_stop_request)
-            libraryStatus("aborted - %d objects loaded out of %d in library",itm,num_list_items);
-	else
+	/* draw the remaining icons while the user can already scroll and pick objects */
+	if (num_icons_pending > 0) {
+	    libraryStatus("%d of %d objects loaded",
+			num_list_items - num_icons_pending, num_list_items);
+	    icon_work = XtAppAddWorkProc(tool_app, make_lib_icons, (XtPointer) NULL);
+	} else {
+	    end_lib_icons();
             libraryStatus("%d library objects in library",num_list_items);
+	}
     } else {
 	flag = False;
     }
@@ -1752,7 +1864,6 @@ static void
 sel_item_icon(Widget w, XButtonEvent *ev)
 {
     int		    i;
-    F_compound	   *compound;
 
     /* get structure having current entry */
     which_name = XtName(w);
@@ -1769,10 +1880,8 @@ sel_item_icon(Widget w, XButtonEvent *ev)
 	    /* make the "Select object" button active now */
 	    FirstArg(XtNsensitive, True);
 	    SetValues(selobj);
-	    /* get the object compound */
-	    compound = lib_compounds[which_num]->compound;
 	    /* put its comments in the comment window */
-	    set_comments(compound->comments);
+	    show_obj_comments(which_num);
 	    /* copy the icon to the preview in case user switches to list view */
 	    copy_icon_to_preview(which_num);
 	    /* and change label in preview label */
@@ -1818,3 +1927,435 @@ copy_icon_to_preview(int object)
 		LIB_PREVIEW_SIZE, LIB_PREVIEW_SIZE, 0, 0);
     update_preview();
 }
+
+/*
+ * Copy the pixels of a library icon to a newly allocated buffer for the
+ * library index, (depth+7)/8 bytes per pixel, most significant first.
+ */
+
+static unsigned char *
+icon_to_thumb(Pixmap icon, long *len)
+{
+    XImage	   *image;
+    unsigned char  *thumb, *t;
+    unsigned long   pix;
+    int		    size, bpp, i, j, k;
+
+    size = appres.library_icon_size;
+    bpp = (tool_dpth + 7) / 8;
+    image = XGetImage(tool_d, icon, 0, 0, size, size, AllPlanes, ZPixmap);
+    if (image == NULL)
+	return NULL;
+    if ((thumb = (unsigned char *) malloc((long) size * size * bpp)) != NULL) {
+	t = thumb;
+	for (j = 0; j < size; j++)
+	    for (i = 0; i < size; i++) {
+		pix = XGetPixel(image, i, j);
+		for (k = bpp - 1; k >= 0; k--)
+		    *t++ = (unsigned char) (pix >> (8 * k));
+	    }
+	*len = (long) size * size * bpp;
+    }
+    XDestroyImage(image);
+    return thumb;
+}
+
+/* put the pixels from the library index into a library icon */
+
+static Boolean
+thumb_to_icon(unsigned char *thumb, long len, Pixmap icon)
+{
+    XImage	   *image;
+    unsigned long   pix;
+    int		    size, bpp, i, j, k;
+
+    size = appres.library_icon_size;
+    bpp = (tool_dpth + 7) / 8;
+    if (len != (long) size * size * bpp)
+	return False;
+    image = XCreateImage(tool_d, tool_v, tool_dpth, ZPixmap, 0, NULL,
+			size, size, 32, 0);
+    if (image == NULL)
+	return False;
+    if ((image->data = malloc(image->bytes_per_line * size)) == NULL) {
+	XDestroyImage(image);
+	return False;
+    }
+    for (j = 0; j < size; j++)
+	for (i = 0; i < size; i++) {
+	    pix = 0;
+	    for (k = 0; k < bpp; k++)
+		pix = (pix << 8) | *thumb++;
+	    XPutPixel(image, i, j, pix);
+	}
+    XPutImage(tool_d, icon, gccache[PAINT], image, 0, 0, 0, 0, size, size);
+    XDestroyImage(image);
+    return True;
+}
+
+/*
+ * Work procedure to draw the icons that weren't in the library index,
+ * one per call so the panel stays responsive.  Icons in the visible part
+ * of the icon view are drawn first.
+ */
+
+static Boolean
+make_lib_icons(XtPointer client_data)
+{
+    int		    itm;
+    struct stat	    st;
+    char	    fname[PATH_MAX];
+    unsigned char  *thumb;
+    long	    thumblen;
+
+    if (library_stop_request || num_icons_pending == 0) {
+	if (num_icons_pending > 0)
+            libraryStatus("aborted - %d objects loaded out of %d in library",
+			num_list_items - num_icons_pending, num_list_items);
+	else
+            libraryStatus("%d library objects in library",num_list_items);
+	/* returning True removes this work procedure */
+	icon_work = (XtWorkProcId) 0;
+	end_lib_icons();
+	return True;
+    }
+
+    itm = next_lib_icon();
+    icon_pending[itm] = False;
+    num_icons_pending--;
+    if (preview_libobj(itm, lib_icons[itm], appres.library_icon_size, 4)) {
+	/* have the label show the new contents of its pixmap */
+	if (XtIsRealized(lib_buttons[itm]))
+	    XClearArea(tool_d, XtWindow(lib_buttons[itm]), 0, 0, 0, 0, True);
+	/* it can be clicked on now */
+	XtAugmentTranslations(lib_buttons[itm],
+			XtParseTranslationTable(object_icon_translations));
+	sprintf(fname, "%s/%s.fig", cur_library_path, cur_objects_names[itm]);
+	if (lib_newindex && stat(fname, &st) == 0 &&
+	    (thumb = icon_to_thumb(lib_icons[itm], &thumblen)) != NULL) {
+		add_lib_index_entry(lib_newindex, cur_objects_names[itm], &st,
+			lib_compounds[itm]->compound->comments, thumb, thumblen);
+		free(thumb);
+		lib_index_changed = True;
+	}
+    } else {
+	/* couldn't read it, show its name instead */
+	FirstArg(XtNbitmap, (Pixmap) 0);
+	SetValues(lib_buttons[itm]);
+	/* which may change its size and so the layout */
+	geom_box_wd = 0;
+    }
+    /* preview_libobj() put the comments of this object in the comment window */
+    show_obj_comments(cur_library_object);
+    libraryStatus("%d of %d objects loaded",
+			num_list_items - num_icons_pending, num_list_items);
+    return False;
+}
+
+/*
+ * Return the first pending icon that is visible in the icon view, or else
+ * the first pending one.  The positions of the buttons are only asked for
+ * again when the width of the box (and so its layout) changes, and the
+ * visible ones only looked for again when the view is scrolled.
+ */
+
+static int
+next_lib_icon(void)
+{
+    Position	    bx, by;
+    Dimension	    bw, vw, vh;
+    int		    i;
+
+    while (first_pending < num_list_items && !icon_pending[first_pending])
+	first_pending++;
+    if (!appres.icon_view)
+	return first_pending;
+
+    FirstArg(XtNx, &bx);
+    NextArg(XtNy, &by);
+    NextArg(XtNwidth, &bw);
+    GetValues(icon_box);
+    FirstArg(XtNwidth, &vw);
+    NextArg(XtNheight, &vh);
+    GetValues(icon_viewport);
+
+    if (bw != geom_box_wd) {
+	for (i = 0; i < num_list_items; i++) {
+	    FirstArg(XtNx, &icon_geom[i].x);
+	    NextArg(XtNy, &icon_geom[i].y);
+	    NextArg(XtNwidth, &icon_geom[i].w);
+	    NextArg(XtNheight, &icon_geom[i].h);
+	    GetValues(lib_buttons[i]);
+	}
+	geom_box_wd = bw;
+	vis_valid = False;
+    }
+    if (!vis_valid || bx != vis_bx || by != vis_by || vw != vis_vw || vh != vis_vh) {
+	vis_lo = num_list_items;
+	vis_hi = -1;
+	for (i = 0; i < num_list_items; i++)
+	    if (bx + icon_geom[i].x + (int) icon_geom[i].w > 0 &&
+		bx + icon_geom[i].x < (int) vw &&
+		by + icon_geom[i].y + (int) icon_geom[i].h > 0 &&
+		by + icon_geom[i].y < (int) vh) {
+		    if (vis_lo > i)
+			vis_lo = i;
+		    vis_hi = i;
+	    }
+	vis_next = vis_lo;
+	vis_bx = bx;
+	vis_by = by;
+	vis_vw = vw;
+	vis_vh = vh;
+	vis_valid = True;
+    }
+    /* buttons in the range may still be left or right of the viewport */
+    for (; vis_next <= vis_hi; vis_next++) {
+	i = vis_next;
+	if (icon_pending[i] &&
+	    bx + icon_geom[i].x + (int) icon_geom[i].w > 0 &&
+	    bx + icon_geom[i].x < (int) vw &&
+	    by + icon_geom[i].y + (int) icon_geom[i].h > 0 &&
+	    by + icon_geom[i].y < (int) vh)
+		return i;
+    }
+    return first_pending;
+}
+
+/* stop drawing icons for the current library and save its index */
+
+static void
+end_lib_icons(void)
+{
+    if (icon_work) {
+	XtRemoveWorkProc(icon_work);
+	icon_work = (XtWorkProcId) 0;
+    }
+    num_icons_pending = 0;
+    /* write the index if any icons had to be drawn or objects have gone */
+    if (lib_newindex && (lib_index_changed || lib_index == NULL ||
+			lib_index->nentries != lib_newindex->nentries))
+	(void) write_lib_index(lib_newindex);
+    if (lib_index)
+	free_lib_index(lib_index);
+    if (lib_newindex)
+	free_lib_index(lib_newindex);
+    lib_index = lib_newindex = (struct lib_index *) NULL;
+    lib_index_changed = False;
+    if (stop)
+	XtSetSensitive(stop, False);
+}
+
+/* don't draw icons while the panel is down (e.g. while an object is being placed) */
+
+static void
+pause_lib_icons(void)
+{
+    if (icon_work) {
+	XtRemoveWorkProc(icon_work);
+	icon_work = (XtWorkProcId) 0;
+    }
+}
+
+static void
+resume_lib_icons(void)
+{
+    if (num_icons_pending > 0 && !icon_work && !library_stop_request)
+	icon_work = XtAppAddWorkProc(tool_app, make_lib_icons, (XtPointer) NULL);
+}
+
+/* put the comments of library object obj in the comment window */
+
+static void
+show_obj_comments(int obj)
+{
+    if (obj < 0)
+	set_comments("");
+    else if (lib_compounds[obj]->compound)
+	set_comments(lib_compounds[obj]->compound->comments);
+    else
+	/* not read yet because its icon came from the library index */
+	set_comments(lib_comments[obj]? lib_comments[obj]: "");
+}
+
+/* search all the libraries for the objects matching the words in the search text */
+
+static void
+search_library(Widget w, XEvent *ev)
+{
+    char	*query;
+    int		 nread, nhits;
+
+    if (loading_library)
+	return;
+    FirstArg(XtNstring, &query);
+    GetValues(search_text);
+
+    /* bring the search index up to date for every search, the libraries may
+       have changed in the meantime; only new or changed objects are read */
+    set_temp_cursor(wait_cursor);
+    libraryStatus("Indexing libraries...");
+    libsearch_begin();
+    nread = scan_search_libs(library_rec, num_library_names);
+    libsearch_end();
+    reset_cursor();
+    if (appres.DEBUG)
+	fprintf(stderr,"Library search: read %d object files\n", nread);
+
+    nhits = libsearch_query(query, &search_hits);
+    if (nhits == 0) {
+	libraryStatus("No objects found for \"%.40s\"", query);
+	if (search_popup)
+	    XtPopdown(search_popup);
+	return;
+    }
+    libraryStatus("%d object%s found for \"%.40s\"", nhits, nhits == 1? "": "s", query);
+    popup_search_results(nhits);
+}
+
+/* add the objects of all libraries in librec[] (and their sub-libraries) to the search index */
+
+static int
+scan_search_libs(struct lib_rec **librec, int num)
+{
+    int		 i, nread;
+
+    nread = 0;
+    for (i = 0; i < num; i++) {
+	/* the same libraries that can be loaded from the menu */
+	if (librec[i]->figs_at_top || librec[i]->nsubs == 0)
+	    nread += libsearch_add_dir(librec[i]->path, librec[i]->longname,
+					(void *) librec[i]);
+	nread += scan_search_libs(librec[i]->subdirs, librec[i]->nsubs);
+    }
+    return nread;
+}
+
+static void
+popup_search_results(int nhits)
+{
+    Widget	 form, viewport, close;
+    int		 i;
+
+    if (search_texts) {
+	for (i = 0; search_texts[i]; i++)
+	    free(search_texts[i]);
+	free(search_texts);
+    }
+    if ((search_texts = (char **) malloc((nhits+1) * sizeof(char *))) == NULL)
+	return;
+    for (i = 0; i < nhits; i++) {
+	search_texts[i] = malloc(strlen(search_hits[i]->name) +
+				strlen(search_hits[i]->libname) + 5);
+	if (search_texts[i] == NULL)
+	    break;
+	sprintf(search_texts[i], "%s  (%s)", search_hits[i]->name, search_hits[i]->libname);
+    }
+    search_texts[i] = NULL;
+    nhits = i;
+
+    if (!search_popup) {
+	FirstArg(XtNx, xposn + 50);
+	NextArg(XtNy, yposn + 100);
+	NextArg(XtNtitle, "Library search");
+	NextArg(XtNcolormap, tool_cm);
+	search_popup = XtCreatePopupShell("library_search",
+				transientShellWidgetClass,
+				library_popup, Args, ArgCount);
+	XtOverrideTranslations(search_popup,
+		XtParseTranslationTable("<Message>WM_PROTOCOLS: CloseLibrarySearch()\n"));
+	form = XtCreateManagedWidget("search_form", formWidgetClass,
+				search_popup, NULL, ZERO);
+
+	FirstArg(XtNlabel, "Objects found (click to select):");
+	NextArg(XtNjustify, XtJustifyLeft);
+	NextArg(XtNborderWidth, 0);
+	NextArg(XtNtop, XtChainTop);
+	NextArg(XtNbottom, XtChainTop);
+	NextArg(XtNleft, XtChainLeft);
+	NextArg(XtNright, XtChainRight);
+	search_label = XtCreateManagedWidget("search_results_label", labelWidgetClass,
+				form, Args, ArgCount);
+
+	FirstArg(XtNallowVert, True);
+	NextArg(XtNallowHoriz, False);
+	NextArg(XtNfromVert, search_label);
+	NextArg(XtNwidth, LIB_FILE_WIDTH);
+	NextArg(XtNheight, 200);
+	NextArg(XtNborderWidth, INTERNAL_BW);
+	NextArg(XtNtop, XtChainTop);
+	NextArg(XtNbottom, XtChainBottom);
+	NextArg(XtNleft, XtChainLeft);
+	NextArg(XtNright, XtChainRight);
+	viewport = XtCreateManagedWidget("search_vport", viewportWidgetClass,
+				form, Args, ArgCount);
+
+	FirstArg(XtNforceColumns, True);	/* one column */
+	NextArg(XtNdefaultColumns, 1);
+	NextArg(XtNborderWidth, 0);
+	NextArg(XtNwidth, LIB_FILE_WIDTH);
+	search_list = XtCreateManagedWidget("search_list", figListWidgetClass,
+				viewport, Args, ArgCount);
+	XtAddCallback(search_list, XtNcallback, search_result_sel, (XtPointer) NULL);
+
+	FirstArg(XtNlabel, "Close");
+	NextArg(XtNfromVert, viewport);
+	NextArg(XtNborderWidth, INTERNAL_BW);
+	NextArg(XtNtop, XtChainBottom);
+	NextArg(XtNbottom, XtChainBottom);
+	NextArg(XtNleft, XtChainLeft);
+	NextArg(XtNright, XtChainLeft);
+	close = XtCreateManagedWidget("close", commandWidgetClass,
+				form, Args, ArgCount);
+	XtAddCallback(close, XtNcallback, search_close, (XtPointer) NULL);
+	XtRealizeWidget(search_popup);
+	(void) XSetWMProtocols(tool_d, XtWindow(search_popup), &wm_delete_window, 1);
+    }
+    XawListChange(search_list, search_texts, nhits, 0, True);
+    XtPopup(search_popup, XtGrabNonexclusive);
+}
+
+/* user clicked on an object in the search results: load its library and select it */
+
+static void
+search_result_sel(Widget w, XtPointer closure, XtPointer call_data)
+{
+    XawListReturnStruct *ret_struct = (XawListReturnStruct *) call_data;
+    XawListReturnStruct	 sel;
+    struct libsearch_obj *obj;
+    struct lib_rec	*librec;
+    int			 i;
+
+    if (loading_library || ret_struct->list_index < 0)
+	return;
+    obj = search_hits[ret_struct->list_index];
+    librec = (struct lib_rec *) obj->library;
+    if (librec == NULL)
+	return;
+    if (librec != cur_library) {
+	load_library(w, (XtPointer) librec, (XtPointer) NULL);
+	if (librec != cur_library)
+	    return;
+    }
+    for (i = 0; library_objects_texts[i]; i++)
+	if (strcmp(library_objects_texts[i], obj->name) == 0)
+	    break;
+    if (library_objects_texts[i] == NULL)
+	return;
+    XawListHighlight(object_list, i);
+    sel.string = library_objects_texts[i];
+    sel.list_index = i;
+    NewObjectSel(object_list, (XtPointer) NULL, (XtPointer) &sel);
+}
+
+static void
+search_close(Widget w, XtPointer closure, XtPointer call_data)
+{
+    XtPopdown(search_popup);
+}
+
+static void
+search_close_action(Widget w, XEvent *ev, String *params, Cardinal *nparams)
+{
+    search_close(w, (XtPointer) NULL, (XtPointer) NULL);
+}
@@ -16,6 +16,7 @@
  */
 
 #define DEF_ICON_SIZE	  60		/* size (square) of object icon */
+#define DEF_LIBRARY_CACHE_DIR "~/.cache/xfig/library" /* where the library indexes are kept */
 
 typedef struct f_libobj {
     struct {
@@ -40,11 +40,14 @@
 /* ---------------------------------------------------------------------- */
 
 
-/* Make sure cache size is set */
+/* The cache size (kbytes) is set by the rottext_cache resource,
+   whose default is CACHE_SIZE_LIMIT from configure */
 
-#ifndef CACHE_SIZE_LIMIT
-#define CACHE_SIZE_LIMIT 0
-#endif /*CACHE_SIZE_LIMIT */
+#define CACHE_LIMIT ((long) appres.rottext_cache*1024)
+
+/* Number of hash chains for looking up cached items */
+
+#define CACHE_HASH_SIZE 512
 
 /* Cache by FID if can't find name because OpenWindows screws up */
 
@@ -81,7 +84,7 @@ typedef struct rotated_text_item_template {
     XImage *ximage;
 
     char *text;
-    char *font_name;
+    Atom font_atom;
     Font fid;
     float angle;
     int align;
@@ -99,11 +102,24 @@ typedef struct rotated_text_item_template {
 
     long int size;
     int cached;
+    unsigned int hash;
 
-    struct rotated_text_item_template *next;
+    /* least recently used first, and the chain of its hash bucket */
+    struct rotated_text_item_template *next, *prev;
+    struct rotated_text_item_template *hash_next;
 } RotatedTextItem;
 
-RotatedTextItem *first_text_item=NULL;
+/*
+ * The cache: a list from the least to the most recently used item, and a
+ * hash table on font, text, angle, alignment and magnification.
+ */
+
+static RotatedTextItem *first_text_item=NULL;
+static RotatedTextItem *last_text_item=NULL;
+static RotatedTextItem *text_hash[CACHE_HASH_SIZE];
+static long int cache_size=0;
+static int cache_items=0;
+static long int cache_hits=0, cache_misses=0;
 
 
 /* ---------------------------------------------------------------------- */
@@ -139,6 +155,9 @@ static int              XRotPaintAlignedString(Display *dpy, XFontStruct *font,
 static int              XRotDrawHorizontalString(Display *dpy, XFontStruct *font, Drawable drawable, GC gc, int x, int y, char *text, int align, int bg);
 static RotatedTextItem *XRotRetrieveFromCache(Display *dpy, XFontStruct *font, float angle, char *text, int align);
 static RotatedTextItem *XRotCreateTextItem(Display *dpy, XFontStruct *font, float angle, char *text, int align);
+static unsigned int     XRotHashItem(Atom font_atom, Font fid, float angle, char *text, int align, float magnify);
+static int              XRotMatchItem(RotatedTextItem *item, Atom font_atom, Font fid, float angle, char *text, int align);
+static void             XRotUnlinkItem(RotatedTextItem *item);
 static void             XRotAddToLinkedList(Display *dpy, RotatedTextItem *item);
 static void             XRotFreeTextItem(Display *dpy, RotatedTextItem *item);
 static XImage          *XRotMagnifyImage(Display *dpy, XImage *ximage);
@@ -697,81 +716,65 @@ static RotatedTextItem
 *XRotRetrieveFromCache(Display *dpy, XFontStruct *font, float angle, char *text, int align)
 {
     Font fid;
-    char *font_name=NULL;
+    Atom font_atom;
     unsigned long name_value;
+    unsigned int hash;
     RotatedTextItem *item=NULL;
-    RotatedTextItem *i1=first_text_item;
+    RotatedTextItem *i1;
 
-    /* get font name, if it exists */
+    /* the atom of the font name if it exists; unlike the name itself,
+       getting it needs no round trip to the server */
     if (XGetFontProperty(font, XA_FONT, &name_value)) {
 	DEBUG_PRINT1("got font name OK\n");
-	font_name=XGetAtomName(dpy, name_value);
+	font_atom=(Atom) name_value;
 	fid=0;
     }
 #ifdef CACHE_FID
     /* otherwise rely (unreliably?) on font ID */
     else {
 	DEBUG_PRINT1("can't get fontname, caching FID\n");
-	font_name=NULL;
+	font_atom=None;
 	fid=font->fid;
     }
 #else
     /* not allowed to cache font ID's */
     else {
 	DEBUG_PRINT1("can't get fontname, can't cache\n");
-	font_name=NULL;
+	font_atom=None;
 	fid=0;
     }
 #endif /*CACHE_FID*/
 
     /* look for a match in cache */
+    hash=XRotHashItem(font_atom, fid, angle, text, align, style.magnify);
+    for (i1=text_hash[hash%CACHE_HASH_SIZE]; i1 && !item; i1=i1->hash_next)
+	if (i1->hash==hash && XRotMatchItem(i1, font_atom, fid, angle, text, align))
+	    item=i1;
 
-    /* matching formula:
-       identical text;
-       identical fontname (if defined, font ID's if not);
-       angles close enough (<0.0001 here, could be smaller);
-       HORIZONTAL alignment matches, OR it's a one line string;
-       magnifications the same */
-
-    while(i1 && !item) {
-	/* match everything EXCEPT fontname/ID */
-	if (strcmp(text, i1->text)==0 &&
-	   fabs(angle-i1->angle)<0.0001 &&
-	   style.magnify==i1->magnify &&
-	   (i1->nl==1 ||
-	    ((align==0)?9:(align-1))%3==
-	      ((i1->align==0)?9:(i1->align-1))%3)) {
-
-	    /* now match fontname/ID */
-	    if (font_name!=NULL && i1->font_name!=NULL) {
-		if (strcmp(font_name, i1->font_name)==0) {
-		    item=i1;
-		    DEBUG_PRINT1("Matched against font names\n");
-		}
-		else
-		    i1=i1->next;
-	    }
-#ifdef CACHE_FID
-	    else if (font_name==NULL && i1->font_name==NULL) {
-		if (fid==i1->fid) {
-		    item=i1;
-		    DEBUG_PRINT1("Matched against FID's\n");
-                }
-		else
-                    i1=i1->next;
-	    }
-#endif /*CACHE_FID*/
+    if (item) {
+	DEBUG_PRINT1("**Found target in cache.\n");
+	cache_hits++;
+	/* it is now the most recently used */
+	if (item!=last_text_item) {
+	    if (item->prev)
+		item->prev->next=item->next;
 	    else
-		i1=i1->next;
+		first_text_item=item->next;
+	    item->next->prev=item->prev;
+	    item->prev=last_text_item;
+	    item->next=NULL;
+	    last_text_item->next=item;
+	    last_text_item=item;
 	}
-	else
-	    i1=i1->next;
     }
-
-    if (item)
-	DEBUG_PRINT1("**Found target in cache.\n");
-    if (!item)
+    else {
 	DEBUG_PRINT1("**No match in cache.\n");
+	cache_misses++;
+    }
+
+    if (appres.DEBUG && (cache_hits+cache_misses)%1000==0)
+	fprintf(stderr,"rotated text cache: %ld hits, %ld misses, %d items, %ld of %ld bytes\n",
+		cache_hits, cache_misses, cache_items, cache_size, CACHE_LIMIT);
 
     /* no match */
     if (!item) {
@@ -782,28 +785,17 @@ static RotatedTextItem
 
 	/* record what it shows */
 	item->text=strdup(text);
-
-	/* fontname or ID */
-	if (font_name!=NULL) {
-	    item->font_name=strdup(font_name);
-	    item->fid=0;
-	}
-	else {
-	    item->font_name=NULL;
-	    item->fid=fid;
-	}
-
+	item->font_atom=font_atom;
+	item->fid=fid;
 	item->angle=angle;
 	item->align=align;
 	item->magnify=style.magnify;
+	item->hash=hash;
 
 	/* cache it */
 	XRotAddToLinkedList(dpy, item);
     }
 
-    if (font_name)
-	XFree(font_name);
-
     /* if XImage is cached, need to recreate the bitmap */
 
 #ifdef CACHE_XIMAGES
@@ -1147,103 +1139,142 @@ static RotatedTextItem
 
 
 /**************************************************************************/
-/*  Adds a text item to the end of the cache, removing as many items      */
-/*      from the front as required to keep cache size below limit         */
+/*  Hash of the cache key of a text item; the horizontal alignment only   */
+/*      counts for strings of more than one line (see XRotMatchItem)      */
 /**************************************************************************/
 
-static void
-XRotAddToLinkedList(Display *dpy, RotatedTextItem *item)
+static unsigned int
+XRotHashItem(Atom font_atom, Font fid, float angle, char *text, int align, float magnify)
 {
+    unsigned int hash;
+    char *c;
+
+    hash=(unsigned int) (font_atom!=None? font_atom: fid);
+    for (c=text; *c; c++)
+	hash=hash*31+(unsigned char)*c;
+    /* angles within 0.0001 match, so hash them coarser than that */
+    hash=hash*31+(unsigned int) (angle*1000.0+0.5);
+    hash=hash*31+(unsigned int) (magnify*100.0+0.5);
+    if (align!=NONE && (c=strchr(text, '\n'))!=NULL && c[1]!='\0')
+	hash=hash*31+((align==0)?9:(align-1))%3;
+    return hash;
+}
 
-    static long int current_size=0;
-    static RotatedTextItem *last=NULL;
-    RotatedTextItem *i1=first_text_item, *i2=NULL;
 
-#ifdef CACHE_BITMAPS
+/* ---------------------------------------------------------------------- */
 
-    /* I don't know how much memory a pixmap takes in the server -
-           probably this + a bit more we can't account for */
 
-    item->size=((item->cols_out-1)/8+1)*item->rows_out;
+/**************************************************************************/
+/*  Does a cached item show this font/text/angle/alignment                */
+/**************************************************************************/
 
-#else
+static int
+XRotMatchItem(RotatedTextItem *item, Atom font_atom, Font fid, float angle, char *text, int align)
+{
+    /* matching formula:
+       identical text;
+       identical fontname (if defined, font ID's if not);
+       angles close enough (<0.0001 here, could be smaller);
+       HORIZONTAL alignment matches, OR it's a one line string;
+       magnifications the same */
 
-    /* this is pretty much the size of a RotatedTextItem */
+    return (strcmp(text, item->text)==0 &&
+	    fabs(angle-item->angle)<0.0001 &&
+	    style.magnify==item->magnify &&
+	    (item->nl==1 ||
+	     ((align==0)?9:(align-1))%3==
+		((item->align==0)?9:(item->align-1))%3) &&
+	    item->font_atom==font_atom && item->fid==fid);
+}
 
-    item->size=((item->cols_out-1)/8+1)*item->rows_out +
-	sizeof(XImage) + strlen(item->text) +
-	    item->nl*8*sizeof(float) + sizeof(RotatedTextItem);
 
-    if (item->font_name!=NULL)
-	item->size+=strlen(item->font_name);
-    else
-	item->size+=sizeof(Font);
+/* ---------------------------------------------------------------------- */
+
+
+/**************************************************************************/
+/*  Removes an item from the cache list and its hash chain                */
+/**************************************************************************/
 
-#endif /*CACHE_BITMAPS */
+static void
+XRotUnlinkItem(RotatedTextItem *item)
+{
+    RotatedTextItem **ip;
 
-    /* count number of items in cache, for debugging */
-    if (appres.DEBUG) {
-	int i=0;
+    if (item->prev)
+	item->prev->next=item->next;
+    else
+	first_text_item=item->next;
+    if (item->next)
+	item->next->prev=item->prev;
+    else
+	last_text_item=item->prev;
 
-	while(i1) {
-	    i++;
-	    i1=i1->next;
+    for (ip=&text_hash[item->hash%CACHE_HASH_SIZE]; *ip; ip=&(*ip)->hash_next)
+	if (*ip==item) {
+	    *ip=item->hash_next;
+	    break;
 	}
-	DEBUG_PRINT2("Cache has %d items.\n", i);
-	i1=first_text_item;
-    }
+
+    cache_size-=item->size;
+    cache_items--;
+    item->cached=0;
+}
+
+
+/* ---------------------------------------------------------------------- */
+
+
+/**************************************************************************/
+/*  Adds a text item to the end of the cache, removing as many least      */
+/*      recently used items as required to keep cache size below limit    */
+/**************************************************************************/
+
+static void
+XRotAddToLinkedList(Display *dpy, RotatedTextItem *item)
+{
+    RotatedTextItem *i1;
+
+    /* the bitmap (in the server, or as an XImage here) and our own record */
+    item->size=((item->cols_out-1)/8+1)*item->rows_out +
+	sizeof(RotatedTextItem) + strlen(item->text) + 1 +
+	    item->nl*8*sizeof(float);
+
+#ifdef CACHE_XIMAGES
+    item->size+=sizeof(XImage);
+#endif /*CACHE_XIMAGES */
 
     DEBUG_PRINT4("current cache size=%ld, new item=%ld, limit=%ld\n",
-		 current_size, item->size, CACHE_SIZE_LIMIT*1024);
+		 cache_size, item->size, CACHE_LIMIT);
 
     /* if this item is bigger than whole cache, forget it */
-    if (item->size>CACHE_SIZE_LIMIT*1024) {
+    if (item->size>CACHE_LIMIT) {
 	DEBUG_PRINT1("Too big to cache\n\n");
 	item->cached=0;
 	return;
     }
 
-    /* remove elements from cache as needed */
-    while(i1 && current_size+item->size>CACHE_SIZE_LIMIT*1024) {
-
+    /* remove least recently used elements from cache as needed */
+    while((i1=first_text_item) && cache_size+item->size>CACHE_LIMIT) {
 	DEBUG_PRINT2("Removed %d bytes\n", i1->size);
-
-	if (i1->font_name!=NULL)
-	    DEBUG_PRINT5("  (`%s'\n   %s\n   angle=%f align=%d)\n",
-			 i1->text, i1->font_name, i1->angle, i1->align);
-
-#ifdef CACHE_FID
-	if (i1->font_name==NULL)
-	    DEBUG_PRINT5("  (`%s'\n  FID=%ld\n   angle=%f align=%d)\n",
-                         i1->text, i1->fid, i1->angle, i1->align);
-#endif /*CACHE_FID*/
-
-	current_size-=i1->size;
-
-	i2=i1->next;
-
+	XRotUnlinkItem(i1);
 	/* free resources used by the unlucky item */
 	XRotFreeTextItem(dpy, i1);
-
-	/* remove it from linked list */
-	first_text_item=i2;
-	i1=i2;
     }
 
-    /* add new item to end of linked list */
-    if (first_text_item==NULL) {
-	item->next=NULL;
+    /* add new item to end of list and to its hash chain */
+    item->next=NULL;
+    item->prev=last_text_item;
+    if (last_text_item)
+	last_text_item->next=item;
+    else
 	first_text_item=item;
-	last=item;
-    }
-    else {
-	item->next=NULL;
-	last->next=item;
-	last=item;
-    }
+    last_text_item=item;
+    item->hash_next=text_hash[item->hash%CACHE_HASH_SIZE];
+    text_hash[item->hash%CACHE_HASH_SIZE]=item;
 
     /* new cache size */
-    current_size+=item->size;
+    cache_size+=item->size;
+    cache_items++;
 
     item->cached=1;
 
@@ -1263,9 +1294,6 @@ XRotFreeTextItem(Display *dpy, RotatedTextItem *item)
 {
     free(item->text);
 
-    if (item->font_name!=NULL)
-	free(item->font_name);
-
     free((char *)item->corners_x);
     free((char *)item->corners_y);
 
@@ -63,6 +63,7 @@
 #define		SRM_HT		16
 
 static int	lasty = -100, lastx = -100;
+static Boolean	top_mark_on = False, side_mark_on = False;	/* a mark is drawn at lastx/lasty */
 static int	troffx = -8, troffy = -10;
 static int	orig_zoomoff;
 static int	last_drag_x, last_drag_y;
@@ -994,6 +995,7 @@ topruler_selected(Widget tool, XButtonEvent *event, String *params, Cardinal *np
 
 void erase_toprulermark(void)
 {
+    top_mark_on = False;
     XClearArea(tool_d, topruler_win, ZOOMX(lastx) + troffx,
 	       TOPRULER_HT + troffy, trm_pr.width,
 	       trm_pr.height, False);
@@ -1001,6 +1003,11 @@ void erase_toprulermark(void)
 
 void set_toprulermark(int x)
 {
+    /* nothing to do if the mark stays on the same pixel */
+    if (top_mark_on && ZOOMX(x) == ZOOMX(lastx)) {
+	lastx = x;
+	return;
+    }
     XClearArea(tool_d, topruler_win, ZOOMX(lastx) + troffx,
 	       TOPRULER_HT + troffy, trm_pr.width,
 	       trm_pr.height, False);
@@ -1008,6 +1015,7 @@ void set_toprulermark(int x)
 	      0, 0, trm_pr.width, trm_pr.height,
 	      ZOOMX(x) + troffx, TOPRULER_HT + troffy);
     lastx = x;
+    top_mark_on = True;
 }
 
 static void
@@ -1020,6 +1028,7 @@ topruler_exposed(Widget tool, XButtonEvent *event, String *params, Cardinal *npa
 
 void redisplay_topruler(void)
 {
+    top_mark_on = False;
     XClearWindow(tool_d, topruler_win);
 }
 
@@ -1170,6 +1179,8 @@ void reset_topruler(void)
     int		    X0,len;
     int		    tickmod, tickskip;
 
+    top_mark_on = False;		/* the ruler is redrawn */
+
     /* top ruler, adjustments for digits are kludges based on 6x13 char */
     XFillRectangle(tool_d, p, tr_erase_gc, 0, 0, TOPRULER_WD, TOPRULER_HT);
 
@@ -1353,6 +1364,7 @@ init_sideruler(Widget tool)
 
 void redisplay_sideruler(void)
 {
+    side_mark_on = False;
     XClearWindow(tool_d, sideruler_win);
 }
 
@@ -1429,6 +1441,8 @@ void reset_sideruler(void)
     int		    Y0;
     int		    tickmod, tickskip;
 
+    side_mark_on = False;		/* the ruler is redrawn */
+
     /* side ruler, adjustments for digits are kludges based on 6x13 char */
     XFillRectangle(tool_d, p, sr_erase_gc, 0, 0, SIDERULER_WD,
 		   (int) (SIDERULER_HT));
@@ -1499,6 +1513,7 @@ void reset_sideruler(void)
 
 void erase_siderulermark(void)
 {
+    side_mark_on = False;
     if (appres.RHS_PANEL)
 	XClearArea(tool_d, sideruler_win,
 		   SIDERULER_WD + srloffx, ZOOMY(lasty) + srloffy,
@@ -1511,6 +1526,11 @@ void erase_siderulermark(void)
 
 void set_siderulermark(int y)
 {
+    /* nothing to do if the mark stays on the same pixel */
+    if (side_mark_on && ZOOMY(y) == ZOOMY(lasty)) {
+	lasty = y;
+	return;
+    }
     if (appres.RHS_PANEL) {
 	/*
 	 * Because the ruler uses a background pixmap, we can win here by
@@ -1535,4 +1555,5 @@ void set_siderulermark(int y)
 		  srrm_pr.height, srroffx, ZOOMY(y) + srroffy);
     }
     lasty = y;
+    side_mark_on = True;
 }
@@ -28,8 +28,11 @@
 #include "w_indpanel.h"
 #include "w_util.h"
 #include "w_msgpanel.h"
+#include "w_zoom.h"
+#include "u_markers.h"
 #include "u_quartic.h"
 #include "u_search.h"
+#include "u_snapindex.h"
 #include "f_util.h"
 #include <math.h>
 #ifndef __FreeBSD__
@@ -42,6 +45,14 @@ Boolean snap_found;
 Boolean snap_msg_set;
 static Boolean snap_held = False;
 
+/* the snap point marked while the pointer moves, in figure coordinates */
+static Boolean hl_shown = False;
+static int hl_x, hl_y;
+
+/* how near (in figure units) the pointer must be to a fixed snap point */
+#define SNAP_TOLERANCE ((int)((display_zoomscale < 20.0? 10: 14) * \
+			PIX_PER_INCH/DISPLAY_PIX_PER_INCH/display_zoomscale))
+
 snap_mode_e snap_mode = SNAP_MODE_NONE;
 
 void snap_release(Widget w, XtPointer closure, XtPointer call_data);
@@ -1160,15 +1171,23 @@ snap_process(px, py, state)
 
   snap_found = False;
   snap_msg_set = False;
-  cur_objmask = M_OBJECT;
-  init_searchproc_right(snap_handler);
-  object_search_right(*px, *py, state);
-  cur_objmask = hold_objmask;
+
+  /* endpoints, midpoints and foci come from the index, nearest the pointer */
+  if (snap_index_nearest(snap_mode, *px, *py, SNAP_TOLERANCE, &snap_gx, &snap_gy)) {
+    snap_found = True;
+  }
+  else {
+    cur_objmask = M_OBJECT;
+    init_searchproc_right(snap_handler);
+    object_search_right(*px, *py, state);
+    cur_objmask = hold_objmask;
+  }
 
   if (True == snap_found) {
     *px = snap_gx;
     *py = snap_gy;
     if (False == snap_held) {
+      snap_unhighlight();
       snap_mode = SNAP_MODE_NONE;
       XtVaSetValues(snap_indicator_label, XtNlabel, "None     " , NULL);
     }
@@ -1199,10 +1218,50 @@ snap_release(w, closure, call_data)
     XtPointer call_data;
 {
   snap_held = False;
+  snap_unhighlight();
   snap_mode = SNAP_MODE_NONE;
   XtVaSetValues(snap_indicator_label, XtNlabel, "None     " , NULL);
 }
 
+/* mark the point that a click at (x, y) would snap to, as the pointer moves */
+
+void
+snap_highlight(int x, int y)
+{
+  int sx, sy;
+
+  if (SNAP_MODE_NONE == snap_mode ||
+      False == snap_index_nearest(snap_mode, x, y, SNAP_TOLERANCE, &sx, &sy)) {
+    snap_unhighlight();
+    return;
+  }
+  if (True == hl_shown && sx == hl_x && sy == hl_y)
+    return;
+  snap_unhighlight();
+  hl_x = sx;
+  hl_y = sy;
+  hl_shown = True;
+  toggle_csrhighlight(hl_x, hl_y);
+}
+
+void
+snap_unhighlight(void)
+{
+  if (True == hl_shown) {
+    toggle_csrhighlight(hl_x, hl_y);
+    hl_shown = False;
+  }
+}
+
+/* the canvas has been cleared and redrawn, put the mark back */
+
+void
+snap_redisplay_highlight(void)
+{
+  if (True == hl_shown)
+    toggle_csrhighlight(hl_x, hl_y);
+}
+
 void
 snap_endpoint(w, closure, call_data)
     Widget    w;
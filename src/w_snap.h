@@ -30,6 +30,9 @@ extern void snap_normal(Widget w, XtPointer closure, XtPointer call_data);
 extern void snap_tangent(Widget w, XtPointer closure, XtPointer call_data);
 extern void snap_intersect(Widget w, XtPointer closure, XtPointer call_data);
 extern Boolean snap_process(int * px, int *py, unsigned int state);
+extern void snap_highlight(int x, int y);
+extern void snap_unhighlight(void);
+extern void snap_redisplay_highlight(void);
 extern void get_line_from_points(double * c, struct f_point * s1, struct f_point * s2);
 extern void snap_rotate_vector(double * dx, double * dy, double x, double y, double theta);
 extern Boolean is_point_on_arc(F_arc * a, int x, int y);
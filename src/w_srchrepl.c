@@ -55,6 +55,7 @@ There is currently no way to undo replace/update operations.
 #include "w_setup.h"
 #include "w_util.h"
 #include "u_create.h"
+#include "u_draw.h"
 
 #include "mode.h"
 #include "u_bound.h"
@@ -225,8 +226,9 @@ replace_text_in_compound(F_compound *com, char *pattern, char *dst)
           t->cstring = new_string(strlen(str));
         }
         strcpy(t->cstring, str);
-        size = textsize(lookfont(x_fontnum(psfont_text(t), t->font),
-				t->size), strlen(t->cstring), t->cstring);
+        text_changed(t);
+        size = text_size(t, lookfont(x_fontnum(psfont_text(t), t->font),
+				t->size));
         t->ascent = size.ascent;
         t->descent = size.descent;
         t->length = size.length;
@@ -0,0 +1,327 @@
+/*
+ * FIG : Facility for Interactive Generation of figures
+ * Copyright (c) 1985-1988 by Supoj Sutanthavibul
+ * Parts Copyright (c) 1989-2007 by Brian V. Smith
+ *
+ * Any party obtaining a copy of these files is granted, free of charge, a
+ * full and unrestricted irrevocable, world-wide, paid up, royalty-free,
+ * nonexclusive right and license to deal in this software and documentation
+ * files (the "Software"), including without limitation the rights to use,
+ * copy, modify, merge, publish distribute, sublicense and/or sell copies of
+ * the Software, and to permit persons who receive copies from any such
+ * party to do so, with the only requirement being that the above copyright
+ * and this permission notice remain intact.
+ *
+ */
+
+/*
+ * Drawing canvas text with Xft.
+ *
+ * The PostScript fonts are asked of fontconfig by their usual family names
+ * (which fontconfig maps to the URW fonts), at the exact zoomed size and
+ * with the text angle as the font matrix, so rotated text is drawn from
+ * rotated glyphs instead of rotating a bitmap of the whole string as
+ * w_rottext.c does.  Xft keeps the rendered glyphs of each open font; the
+ * fonts themselves are kept here, the least recently used being closed
+ * when there are XFT_CACHE_SIZE of them.
+ *
+ * The length, ascent and descent of such texts are taken from Xft too
+ * (text_size() in u_draw.c), so their bounds, selection markers and
+ * redisplay areas are those of what is drawn.
+ *
+ * Only used on TrueColor visuals, for Latin-1 text, and not for
+ * INV_PAINT (which Xft cannot do); draw_text() falls back to pw_text()
+ * otherwise.
+ */
+
+#include "fig.h"
+#include "resources.h"
+#include "object.h"
+#include "w_xfttext.h"
+
+#ifdef USE_XFT
+
+#include <X11/Xft/Xft.h>
+#include "paintop.h"
+#include "u_fonts.h"
+#include "w_canvas.h"
+#include "w_indpanel.h"
+#include "w_color.h"
+#include "w_drawprim.h"
+#include "w_layers.h"
+#include "w_setup.h"
+
+#define XFT_CACHE_SIZE	32
+
+/* fontconfig names of the PostScript fonts, in the order of ps_fontinfo[] */
+
+static struct {
+    char	   *family;
+    int		    weight, slant;
+} xft_fonts[NUM_FONTS] = {
+    {"Times",			FC_WEIGHT_REGULAR,	FC_SLANT_ROMAN},
+    {"Times",			FC_WEIGHT_REGULAR,	FC_SLANT_ITALIC},
+    {"Times",			FC_WEIGHT_BOLD,		FC_SLANT_ROMAN},
+    {"Times",			FC_WEIGHT_BOLD,		FC_SLANT_ITALIC},
+    {"ITC Avant Garde Gothic",	FC_WEIGHT_BOOK,		FC_SLANT_ROMAN},
+    {"ITC Avant Garde Gothic",	FC_WEIGHT_BOOK,		FC_SLANT_OBLIQUE},
+    {"ITC Avant Garde Gothic",	FC_WEIGHT_DEMIBOLD,	FC_SLANT_ROMAN},
+    {"ITC Avant Garde Gothic",	FC_WEIGHT_DEMIBOLD,	FC_SLANT_OBLIQUE},
+    {"ITC Bookman",		FC_WEIGHT_LIGHT,	FC_SLANT_ROMAN},
+    {"ITC Bookman",		FC_WEIGHT_LIGHT,	FC_SLANT_ITALIC},
+    {"ITC Bookman",		FC_WEIGHT_DEMIBOLD,	FC_SLANT_ROMAN},
+    {"ITC Bookman",		FC_WEIGHT_DEMIBOLD,	FC_SLANT_ITALIC},
+    {"Courier",			FC_WEIGHT_REGULAR,	FC_SLANT_ROMAN},
+    {"Courier",			FC_WEIGHT_REGULAR,	FC_SLANT_OBLIQUE},
+    {"Courier",			FC_WEIGHT_BOLD,		FC_SLANT_ROMAN},
+    {"Courier",			FC_WEIGHT_BOLD,		FC_SLANT_OBLIQUE},
+    {"Helvetica",		FC_WEIGHT_REGULAR,	FC_SLANT_ROMAN},
+    {"Helvetica",		FC_WEIGHT_REGULAR,	FC_SLANT_OBLIQUE},
+    {"Helvetica",		FC_WEIGHT_BOLD,		FC_SLANT_ROMAN},
+    {"Helvetica",		FC_WEIGHT_BOLD,		FC_SLANT_OBLIQUE},
+    {"Helvetica Narrow",	FC_WEIGHT_REGULAR,	FC_SLANT_ROMAN},
+    {"Helvetica Narrow",	FC_WEIGHT_REGULAR,	FC_SLANT_OBLIQUE},
+    {"Helvetica Narrow",	FC_WEIGHT_BOLD,		FC_SLANT_ROMAN},
+    {"Helvetica Narrow",	FC_WEIGHT_BOLD,		FC_SLANT_OBLIQUE},
+    {"New Century Schoolbook",	FC_WEIGHT_REGULAR,	FC_SLANT_ROMAN},
+    {"New Century Schoolbook",	FC_WEIGHT_REGULAR,	FC_SLANT_ITALIC},
+    {"New Century Schoolbook",	FC_WEIGHT_BOLD,		FC_SLANT_ROMAN},
+    {"New Century Schoolbook",	FC_WEIGHT_BOLD,		FC_SLANT_ITALIC},
+    {"Palatino",		FC_WEIGHT_REGULAR,	FC_SLANT_ROMAN},
+    {"Palatino",		FC_WEIGHT_REGULAR,	FC_SLANT_ITALIC},
+    {"Palatino",		FC_WEIGHT_BOLD,		FC_SLANT_ROMAN},
+    {"Palatino",		FC_WEIGHT_BOLD,		FC_SLANT_ITALIC},
+    {NULL,			0,			0},	/* Symbol */
+    {"ITC Zapf Chancery",	FC_WEIGHT_MEDIUM,	FC_SLANT_ITALIC},
+    {NULL,			0,			0},	/* ZapfDingbats */
+};
+
+static struct xft_cache {
+    int		    fnum;
+    double	    size;		/* pixel size */
+    float	    angle;
+    XftFont	   *font;
+    unsigned long   used;		/* xft_clock when last used */
+} xft_cache[XFT_CACHE_SIZE];
+
+static unsigned long xft_clock = 0;
+static XftDraw	   *xft_draw = NULL;
+static Drawable	    xft_drawable;
+
+static Boolean	    xft_usable(F_text *text);
+static XftFont	   *xft_font(F_text *text);
+static XftFont	   *xft_open(int fnum, double size, float angle);
+static double	    xft_size(F_text *text, double zoom);
+static void	    xft_color(Pixel pixel, XftColor *color);
+static unsigned short mask_value(Pixel pixel, unsigned long mask);
+
+/* whether text can be drawn with Xft for op */
+
+Boolean
+xft_text_usable(F_text *text, int op)
+{
+    if (op == INV_PAINT || !xft_usable(text))
+	return False;
+    return xft_font(text) != NULL;
+}
+
+/*
+ * Put the size of text, unzoomed and in Fig units, in *size as textsize()
+ * does for the X fonts.  The length covers the ink of a slanted last
+ * character too.  Returns False if text is not drawn with Xft.
+ */
+
+Boolean
+xft_text_size(F_text *text, PR_SIZE *size)
+{
+    XftFont	   *font;
+    XGlyphInfo	    ext;
+    int		    right;
+
+    if (!xft_usable(text) || (font = xft_open(x_fontnum(psfont_text(text),
+				text->font), xft_size(text, 1.0), 0.0)) == NULL)
+	return False;
+    XftTextExtents8(tool_d, font, (FcChar8 *) text->cstring, strlen(text->cstring), &ext);
+    right = ext.width - ext.x;
+    size->length = ZOOM_FACTOR * max2(ext.xOff, right);
+    size->ascent = ZOOM_FACTOR * ext.y;
+    size->descent = ZOOM_FACTOR * (ext.height - ext.y);
+    return True;
+}
+
+/* the width (in pixels) of text at the current zoom */
+
+int
+xft_text_width(F_text *text)
+{
+    XftFont	   *font;
+    XGlyphInfo	    ext;
+
+    if ((font = xft_font(text)) == NULL)
+	return 0;
+    XftTextExtents8(tool_d, font, (FcChar8 *) text->cstring, strlen(text->cstring), &ext);
+    /* the advance is along the text angle */
+    return (int) (sqrt((double) ext.xOff*ext.xOff + (double) ext.yOff*ext.yOff) + 0.5);
+}
+
+/*
+ * Draw text with its baseline starting at (x, y) (Fig units) in window w.
+ * For ERASE, the box around the ink of the (rotated) glyphs is cleared,
+ * so no anti-aliased edges are left behind.
+ */
+
+void
+xft_draw_text(Window w, int x, int y, int op, F_text *text)
+{
+    XftFont	   *font;
+    XftColor	    color;
+    XGlyphInfo	    ext;
+    XRectangle	    clip;
+    Color	    col;
+    int		    zx, zy;
+
+    if ((font = xft_font(text)) == NULL)
+	return;
+    zx = ZOOMX(x);
+    zy = ZOOMY(y);
+
+    if (op == ERASE) {
+	XftTextExtents8(tool_d, font, (FcChar8 *) text->cstring,
+			strlen(text->cstring), &ext);
+	XFillRectangle(tool_d, w, gccache[ERASE], zx - ext.x - 1, zy - ext.y - 1,
+			ext.width + 2, ext.height + 2);
+	return;
+    }
+
+    if (xft_draw == NULL) {
+	if ((xft_draw = XftDrawCreate(tool_d, w, tool_v, tool_cm)) == NULL)
+	    return;
+    } else if (xft_drawable != w) {
+	XftDrawChange(xft_draw, w);
+    }
+    xft_drawable = w;
+    clip.x = clip_xmin;
+    clip.y = clip_ymin;
+    clip.width = clip_xmax - clip_xmin + 1;
+    clip.height = clip_ymax - clip_ymin + 1;
+    XftDrawSetClipRectangles(xft_draw, 0, 0, &clip, 1);
+
+    /* if this depth is inactive, draw the text in gray */
+    col = text->color;
+    if (draw_parent_gray || (text->depth < MAX_DEPTH+1 && !active_layer(text->depth)))
+	col = MED_GRAY;
+    xft_color(x_color(col), &color);
+    XftDrawString8(xft_draw, &color, font, zx, zy,
+		(FcChar8 *) text->cstring, strlen(text->cstring));
+}
+
+/* whether the font of text can be drawn with Xft at all */
+
+static Boolean
+xft_usable(F_text *text)
+{
+    if (!appres.xft_text || !DIRECT_PIXELS)
+	return False;
+#ifdef I18N
+    if (appres.international)
+	return False;
+#endif
+    return xft_fonts[x_fontnum(psfont_text(text), text->font)].family != NULL;
+}
+
+/* pixel size of text at zoom, as lookfont() would use */
+
+static double
+xft_size(F_text *text, double zoom)
+{
+    double	    size;
+
+    size = text->size * zoom;
+    if (appres.correct_font_size)
+	size *= 80.0/72.0;
+    return size;
+}
+
+/* the Xft font for text at the current zoom */
+
+static XftFont *
+xft_font(F_text *text)
+{
+    return xft_open(x_fontnum(psfont_text(text), text->font),
+			xft_size(text, display_zoomscale), text->angle);
+}
+
+/* find or open the Xft font fnum of pixel size size, rotated by angle */
+
+static XftFont *
+xft_open(int fnum, double size, float angle)
+{
+    struct xft_cache *c, *victim;
+    FcMatrix	    matrix;
+    int		    i;
+
+    if (xft_fonts[fnum].family == NULL)
+	return NULL;
+
+    victim = &xft_cache[0];
+    for (i = 0; i < XFT_CACHE_SIZE; i++) {
+	c = &xft_cache[i];
+	if (c->font && c->fnum == fnum && c->size == size && c->angle == angle) {
+	    c->used = ++xft_clock;
+	    return c->font;
+	}
+	if (c->font == NULL || (victim->font && c->used < victim->used))
+	    victim = c;
+    }
+
+    if (victim->font)
+	XftFontClose(tool_d, victim->font);
+    FcMatrixInit(&matrix);
+    if (angle != 0.0)
+	FcMatrixRotate(&matrix, cos(angle), sin(angle));
+    victim->font = XftFontOpen(tool_d, tool_sn,
+			XFT_FAMILY, XftTypeString, xft_fonts[fnum].family,
+			XFT_WEIGHT, XftTypeInteger, xft_fonts[fnum].weight,
+			XFT_SLANT, XftTypeInteger, xft_fonts[fnum].slant,
+			XFT_PIXEL_SIZE, XftTypeDouble, size,
+			XFT_MATRIX, XftTypeMatrix, &matrix,
+			NULL);
+    victim->fnum = fnum;
+    victim->size = size;
+    victim->angle = angle;
+    victim->used = ++xft_clock;
+    if (victim->font == NULL && appres.DEBUG)
+	fprintf(stderr,"No Xft font for %s\n", xft_fonts[fnum].family);
+    return victim->font;
+}
+
+/* the Xft color of a pixel of the (TrueColor) visual */
+
+static void
+xft_color(Pixel pixel, XftColor *color)
+{
+    color->pixel = pixel;
+    color->color.red = mask_value(pixel, tool_v->red_mask);
+    color->color.green = mask_value(pixel, tool_v->green_mask);
+    color->color.blue = mask_value(pixel, tool_v->blue_mask);
+    color->color.alpha = 0xffff;
+}
+
+/* the part of pixel in mask, scaled to 16 bits */
+
+static unsigned short
+mask_value(Pixel pixel, unsigned long mask)
+{
+    unsigned long   v;
+
+    if (mask == 0)
+	return 0;
+    while ((mask & 1) == 0) {
+	mask >>= 1;
+	pixel >>= 1;
+    }
+    v = pixel & mask;
+    return (unsigned short) (v * 0xffff / mask);
+}
+
+#endif /* USE_XFT */
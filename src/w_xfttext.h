@@ -0,0 +1,27 @@
+/*
+ * FIG : Facility for Interactive Generation of figures
+ * Copyright (c) 1985-1988 by Supoj Sutanthavibul
+ * Parts Copyright (c) 1989-2007 by Brian V. Smith
+ *
+ * Any party obtaining a copy of these files is granted, free of charge, a
+ * full and unrestricted irrevocable, world-wide, paid up, royalty-free,
+ * nonexclusive right and license to deal in this software and documentation
+ * files (the "Software"), including without limitation the rights to use,
+ * copy, modify, merge, publish distribute, sublicense and/or sell copies of
+ * the Software, and to permit persons who receive copies from any such
+ * party to do so, with the only requirement being that the above copyright
+ * and this permission notice remain intact.
+ *
+ */
+
+#ifndef W_XFTTEXT_H
+#define W_XFTTEXT_H
+
+#ifdef USE_XFT
+extern Boolean	xft_text_usable(F_text *text, int op);
+extern int	xft_text_width(F_text *text);
+extern Boolean	xft_text_size(F_text *text, PR_SIZE *size);
+extern void	xft_draw_text(Window w, int x, int y, int op, F_text *text);
+#endif /* USE_XFT */
+
+#endif /* W_XFTTEXT_H */